@@ -71,6 +71,7 @@
 #include <utils/ini.h>
 #include <utils/list.h>
 #include <utils/sprintf.h>
+#include <utils/trace.h>
 #include <utils/types.h>
 #include <utils/util.h>
 
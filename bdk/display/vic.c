@@ -534,6 +534,60 @@ int vic_compose()
 	return res;
 }
 
+int vic_compose_rect(u32 x1, u32 y1, u32 x2, u32 y2)
+{
+	u32 max_x = vic_cfg.out_sfc_cfg.OutSurfaceWidth;
+	u32 max_y = vic_cfg.out_sfc_cfg.OutSurfaceHeight;
+
+	// Expand to full surface if out of range.
+	if (x1 > x2 || y1 > y2 || x2 > max_x || y2 > max_y)
+	{
+		x1 = 0;
+		y1 = 0;
+		x2 = max_x;
+		y2 = max_y;
+	}
+
+	// Wait for previous composition to finish before changing the config.
+	int res = _vic_wait_idle();
+
+	// Limit input and output to the damaged area. Rectangles are in surface space, before flip/transpose.
+	vic_cfg.out_cfg.TargetRectLeft   = x1;
+	vic_cfg.out_cfg.TargetRectRight  = x2;
+	vic_cfg.out_cfg.TargetRectTop    = y1;
+	vic_cfg.out_cfg.TargetRectBottom = y2;
+
+	vic_cfg.slots[0].slot_cfg.SourceRectLeft   = x1 << 16;
+	vic_cfg.slots[0].slot_cfg.SourceRectRight  = x2 << 16;
+	vic_cfg.slots[0].slot_cfg.SourceRectTop    = y1 << 16;
+	vic_cfg.slots[0].slot_cfg.SourceRectBottom = y2 << 16;
+
+	vic_cfg.slots[0].slot_cfg.DestRectLeft   = x1;
+	vic_cfg.slots[0].slot_cfg.DestRectRight  = x2;
+	vic_cfg.slots[0].slot_cfg.DestRectTop    = y1;
+	vic_cfg.slots[0].slot_cfg.DestRectBottom = y2;
+
+	// Flush data.
+	bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLEAN_WAY, false);
+
+	// Reparse parameters and push them to surface cache.
+	_vic_write_priv(VIC_SC_PRAMBASE, (u32)&vic_cfg >> 8);
+	_vic_write_priv(VIC_SC_PRAMSIZE, sizeof(vic_config_t) >> 6);
+	res |= _vic_wait_idle();
+	_vic_write_priv(VIC_BL_CONFIG, SLOTMASK(0x1F) | PROCESS_CFG_STRUCT_TRIGGER | SUBPARTITION_MODE);
+	res |= _vic_wait_idle();
+
+	// Start composition of the area.
+	_vic_write_priv(VIC_FC_COMPOSE, COMPOSE_START);
+
+	return res;
+}
+
+int vic_wait_idle()
+{
+	return _vic_wait_idle();
+}
+
 int vic_init()
 {
 	// Ease the stress to APB.
@@ -57,6 +57,8 @@ typedef struct _vic_surface_t
 
 void vic_set_surface(vic_surface_t *sfc);
 int  vic_compose();
+int  vic_compose_rect(u32 x1, u32 y1, u32 x2, u32 y2);
+int  vic_wait_idle();
 int  vic_init();
 void vic_end();
 
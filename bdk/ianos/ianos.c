@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2018 M4xw
- * Copyright (c) 2018-2019 CTCaer
+ * Copyright (c) 2018-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -19,18 +19,35 @@
 
 #include "ianos.h"
 #include "elfload/elfload.h"
+#include <memory_map.h>
 #include <module.h>
 #include <mem/heap.h>
 #include <power/max7762x.h>
 #include <storage/sd.h>
 #include <utils/types.h>
+#include <utils/util.h>
 
 #include <gfx_utils.h>
 
 #define IRAM_LIB_ADDR 0x4002B000
 #define DRAM_LIB_ADDR 0xE0000000
 
+#define IANOS_CACHE_MAGIC 0x434E4149 // IANC.
+
+#define IANOS_PRELINK_DIR     "bootloader/sys/prelink"
+#define IANOS_PRELINK_MAGIC   0x504E4149 // IANP.
+#define IANOS_PRELINK_VERSION 1
+
+typedef struct _ianos_prelink_hdr_t
+{
+	u32 magic;
+	u32 version;
+	ianos_cache_entry_t key; // Image relocated to key.addr.
+	u32 crc32;
+} ianos_prelink_hdr_t;
+
 extern heap_t _heap;
+extern volatile nyx_storage_t *nyx_str;
 
 void *elfBuf = NULL;
 void *fileBuf = NULL;
@@ -68,11 +85,153 @@ static bool _ianos_read_cb(el_ctx *ctx, void *dest, size_t numberBytes, size_t o
 	return true;
 }
 
+void ianos_cache_reset()
+{
+	ianos_cache_t *cache = (ianos_cache_t *)&nyx_str->ianos_cache;
+
+	memset(cache, 0, sizeof(ianos_cache_t));
+	cache->magic = IANOS_CACHE_MAGIC;
+}
+
+static ianos_cache_entry_t *_ianos_cache_find(const ianos_cache_entry_t *key)
+{
+	ianos_cache_t *cache = (ianos_cache_t *)&nyx_str->ianos_cache;
+
+	if (cache->magic != IANOS_CACHE_MAGIC)
+		return NULL;
+
+	for (u32 i = 0; i < cache->count; i++)
+	{
+		ianos_cache_entry_t *entry = &cache->entries[i];
+		if (entry->path_crc32 == key->path_crc32 &&
+			entry->src_size   == key->src_size   &&
+			entry->src_time   == key->src_time   &&
+			entry->type       == key->type)
+		{
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static void *_ianos_cache_alloc(u32 size)
+{
+	ianos_cache_t *cache = (ianos_cache_t *)&nyx_str->ianos_cache;
+
+	if (cache->magic != IANOS_CACHE_MAGIC)
+		ianos_cache_reset();
+
+	size = ALIGN(size, 0x10);
+	if (cache->count >= IANOS_CACHE_ENTRIES || (cache->used + size) > IANOS_CACHE_SZ)
+		return NULL;
+
+	return (void *)(IANOS_CACHE_ADDR + cache->used);
+}
+
+static void _ianos_cache_insert(ianos_cache_entry_t *key)
+{
+	ianos_cache_t *cache = (ianos_cache_t *)&nyx_str->ianos_cache;
+
+	memcpy(&cache->entries[cache->count], key, sizeof(ianos_cache_entry_t));
+	cache->used += ALIGN(key->size, 0x10);
+	cache->count++;
+}
+
+static void _ianos_prelink_path(char *path, const ianos_cache_entry_t *key)
+{
+	s_printf(path, IANOS_PRELINK_DIR"/%08X.bin", key->path_crc32);
+}
+
+static uintptr_t _ianos_prelink_load(ianos_cache_entry_t *key)
+{
+	FIL fp;
+	char path[64];
+	ianos_prelink_hdr_t hdr;
+
+	_ianos_prelink_path(path, key);
+	if (f_open(&fp, path, FA_READ))
+		return 0;
+
+	if (f_read(&fp, &hdr, sizeof(ianos_prelink_hdr_t), NULL) ||
+		hdr.magic              != IANOS_PRELINK_MAGIC ||
+		hdr.version            != IANOS_PRELINK_VERSION ||
+		hdr.key.src_size       != key->src_size ||
+		hdr.key.src_time       != key->src_time ||
+		hdr.key.type           != key->type)
+	{
+		goto out;
+	}
+
+	// Image is only valid at the address it was relocated to.
+	void *image = _ianos_cache_alloc(hdr.key.size);
+	if ((u32)image != hdr.key.addr)
+		goto out;
+
+	if (f_read(&fp, image, hdr.key.size, NULL) || crc32_calc(0, image, hdr.key.size) != hdr.crc32)
+		goto out;
+
+	f_close(&fp);
+
+	memcpy(key, &hdr.key, sizeof(ianos_cache_entry_t));
+	_ianos_cache_insert(key);
+
+	return key->addr + key->entry;
+
+out:
+	f_close(&fp);
+
+	return 0;
+}
+
+static void _ianos_prelink_save(const ianos_cache_entry_t *key)
+{
+	char path[64];
+	ianos_prelink_hdr_t *hdr = malloc(sizeof(ianos_prelink_hdr_t) + key->size);
+
+	hdr->magic   = IANOS_PRELINK_MAGIC;
+	hdr->version = IANOS_PRELINK_VERSION;
+	memcpy(&hdr->key, key, sizeof(ianos_cache_entry_t));
+	memcpy((u8 *)hdr + sizeof(ianos_prelink_hdr_t), (void *)key->addr, key->size);
+	hdr->crc32   = crc32_calc(0, (u8 *)hdr + sizeof(ianos_prelink_hdr_t), key->size);
+
+	f_mkdir(IANOS_PRELINK_DIR);
+	_ianos_prelink_path(path, key);
+	sd_save_to_file(hdr, sizeof(ianos_prelink_hdr_t) + key->size, path);
+
+	free(hdr);
+}
+
 //TODO: Support shared libraries.
 uintptr_t ianos_loader(char *path, elfType_t type, void *moduleConfig)
 {
 	el_ctx ctx;
+	FILINFO fno;
 	uintptr_t epaddr = 0;
+	void *cache_buf = NULL;
+	ianos_cache_entry_t key;
+
+	// Relocated DRAM libraries are cached by path, file size/time and type.
+	bool cacheable = (type & 0xFFFF) == DRAM_LIB && !f_stat(path, &fno);
+	if (cacheable)
+	{
+		memset(&key, 0, sizeof(ianos_cache_entry_t));
+		key.path_crc32 = crc32_calc(0, (const u8 *)path, strlen(path));
+		key.src_size   = fno.fsize;
+		key.src_time   = fno.fdate << 16 | fno.ftime;
+		key.type       = type;
+
+		ianos_cache_entry_t *entry = _ianos_cache_find(&key);
+		if (entry)
+		{
+			epaddr = entry->addr + entry->entry;
+			goto launch;
+		}
+
+		epaddr = _ianos_prelink_load(&key);
+		if (epaddr)
+			goto launch;
+	}
 
 	// Read library.
 	fileBuf = sd_file_read(path, NULL);
@@ -93,7 +252,9 @@ uintptr_t ianos_loader(char *path, elfType_t type, void *moduleConfig)
 		elfBuf = (void *)DRAM_LIB_ADDR;
 		break;
 	default:
-		elfBuf = malloc(ctx.memsz); // Aligned to 0x10 by default.
+		if (cacheable)
+			cache_buf = _ianos_cache_alloc(ctx.memsz);
+		elfBuf = cache_buf ? cache_buf : malloc(ctx.memsz); // Aligned to 0x10 by default.
 	}
 
 	if (!elfBuf)
@@ -107,11 +268,27 @@ uintptr_t ianos_loader(char *path, elfType_t type, void *moduleConfig)
 	if (el_relocate(&ctx))
 		goto out_free;
 
-	// Launch.
 	epaddr = ctx.ehdr.e_entry + (uintptr_t)elfBuf;
-	moduleEntrypoint_t ep = (moduleEntrypoint_t)epaddr;
 
-	_ianos_call_ep(ep, moduleConfig);
+	// Keep relocated image for later loads and prelink it for next boot.
+	if (cache_buf)
+	{
+		key.addr  = (u32)cache_buf;
+		key.size  = ctx.memsz;
+		key.entry = ctx.ehdr.e_entry;
+		_ianos_cache_insert(&key);
+		_ianos_prelink_save(&key);
+	}
+
+	free(fileBuf);
+	elfBuf = NULL;
+	fileBuf = NULL;
+
+launch:
+	// Launch.
+	_ianos_call_ep((moduleEntrypoint_t)epaddr, moduleConfig);
+
+	return epaddr;
 
 out_free:
 	free(fileBuf);
@@ -120,4 +297,4 @@ out_free:
 
 out:
 	return epaddr;
-}
\ No newline at end of file
+}
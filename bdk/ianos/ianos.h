@@ -29,6 +29,28 @@ typedef enum
 	KEEP_IN_RAM = (1 << 31)  // Shared library mask.
 } elfType_t;
 
+#define IANOS_CACHE_ENTRIES 8
+
+typedef struct _ianos_cache_entry_t
+{
+	u32 path_crc32;
+	u32 src_size;
+	u32 src_time;
+	u32 type;
+	u32 addr;
+	u32 size;
+	u32 entry;
+} ianos_cache_entry_t;
+
+typedef struct _ianos_cache_t
+{
+	u32 magic;
+	u32 used;
+	u32 count;
+	ianos_cache_entry_t entries[IANOS_CACHE_ENTRIES];
+} ianos_cache_t;
+
+void ianos_cache_reset();
 uintptr_t ianos_loader(char *path, elfType_t type, void* config);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LZ4C_H_
+#define _LZ4C_H_
+
+#include <utils/types.h>
+
+#define LZ4C_MAGIC          0x43345A4C // "LZ4C".
+#define LZ4C_CHUNK_SIZE_MAX SZ_4M
+
+/*
+ * LZ4 chunked file. Header is followed by a table with the compressed size of
+ * each chunk and then by the chunks. A chunk that has a compressed size equal
+ * to its uncompressed one is stored as is.
+ */
+typedef struct _lz4c_hdr_t
+{
+	u32 magic;
+	u32 size;       // Uncompressed size.
+	u32 chunk_size; // Uncompressed size of each chunk. Last one can be smaller.
+	u32 chunks;
+} lz4c_hdr_t;
+
+#endif
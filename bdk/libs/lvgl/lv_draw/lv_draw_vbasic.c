@@ -47,6 +47,16 @@ static void sw_color_fill(lv_area_t * mem_area, lv_color_t * mem, const lv_area_
 static inline lv_color_t color_mix_2_alpha(lv_color_t bg_color, lv_opa_t bg_opa, lv_color_t fg_color, lv_opa_t fg_opa);
 #endif
 
+#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP == 0
+#define VBASIC_PX32    1
+static inline void px32_fill(uint32_t * dest, uint32_t color, uint32_t length);
+static inline uint32_t px32_mix_pre(uint32_t bg, uint32_t fg_rb, uint32_t fg_g, uint32_t opa_inv);
+static inline uint32_t px32_mix(uint32_t fg, uint32_t bg, uint32_t opa);
+static void px32_map_alpha(uint32_t * dest, const uint32_t * src, uint32_t length, lv_opa_t opa);
+#else
+#define VBASIC_PX32    0
+#endif
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -329,6 +339,11 @@ void lv_vletter(const lv_point_t * pos_p, const lv_area_t * mask_p,
 
     lv_disp_t * disp = lv_disp_get_active();
 
+#if LV_COLOR_SCREEN_TRANSP == 0
+    /*Mixing with full opacity doesn't depend on the background, so calculate it once*/
+    lv_color_t cover_color = lv_color_mix(color, color, LV_OPA_COVER);
+#endif
+
     uint8_t letter_px;
     lv_opa_t px_opa;
     for(row = row_start; row < row_end; row ++) {
@@ -352,7 +367,8 @@ void lv_vletter(const lv_point_t * pos_p, const lv_area_t * mask_p,
                                         color, px_opa);
                 } else {
 #if LV_COLOR_SCREEN_TRANSP == 0
-                    *vdb_buf_tmp = lv_color_mix(color, *vdb_buf_tmp, px_opa);
+                    if(px_opa == LV_OPA_COVER) *vdb_buf_tmp = cover_color;
+                    else *vdb_buf_tmp = lv_color_mix(color, *vdb_buf_tmp, px_opa);
 #else
                     *vdb_buf_tmp = color_mix_2_alpha(*vdb_buf_tmp, (*vdb_buf_tmp).alpha, color, px_opa);
 #endif
@@ -472,6 +488,17 @@ void lv_vmap(const lv_area_t * cords_p, const lv_area_t * mask_p,
         }
     }
 
+#if VBASIC_PX32
+    /*Images with alpha byte only: copy opaque runs and blend the rest with paired channels*/
+    else if(chroma_key == false && alpha_byte && recolor_opa == LV_OPA_TRANSP && !disp->driver.vdb_wr) {
+        for(row = masked_a.y1; row <= masked_a.y2; row++) {
+            px32_map_alpha((uint32_t *)vdb_buf_tmp, (const uint32_t *)map_p, map_useful_w, opa);
+            map_p += map_width * px_size_byte;  /*Next row on the map*/
+            vdb_buf_tmp += vdb_width;           /*Next row on the VDB*/
+        }
+    }
+#endif
+
     /*In the other cases every pixel need to be checked one-by-one*/
     else {
         lv_color_t chroma_key_color = LV_COLOR_TRANSP;
@@ -561,9 +588,17 @@ static void sw_mem_blend(lv_color_t * dest, const lv_color_t * src, uint32_t len
         memcpy(dest, src, length * sizeof(lv_color_t));
     } else {
         uint32_t col;
+#if VBASIC_PX32
+        uint32_t * d32 = (uint32_t *)dest;
+        const uint32_t * s32 = (const uint32_t *)src;
+        for(col = 0; col < length; col++) {
+            d32[col] = px32_mix(s32[col], d32[col], opa);
+        }
+#else
         for(col = 0; col < length; col++) {
             dest[col] = lv_color_mix(src[col], dest[col], opa);
         }
+#endif
     }
 }
 
@@ -594,7 +629,14 @@ static void sw_color_fill(lv_area_t * mem_area, lv_color_t * mem, const lv_area_
 
         /*Run simpler function without opacity*/
         if(opa == LV_OPA_COVER) {
-
+#if VBASIC_PX32
+            /*Fill every row directly with multi-pixel stores*/
+            uint32_t fill_w = fill_area->x2 - fill_area->x1 + 1;
+            for(row = fill_area->y1; row <= fill_area->y2; row++) {
+                px32_fill((uint32_t *)&mem[fill_area->x1], color.full, fill_w);
+                mem += mem_width;
+            }
+#else
             /*Fill the first row with 'color'*/
             for(col = fill_area->x1; col <= fill_area->x2; col++) {
                 mem[col] = color;
@@ -609,10 +651,30 @@ static void sw_color_fill(lv_area_t * mem_area, lv_color_t * mem, const lv_area_
                 memcpy(&mem[fill_area->x1], mem_first, copy_size);
                 mem += mem_width;
             }
+#endif
         }
         /*Calculate with alpha too*/
         else {
-
+#if VBASIC_PX32
+            /*Premultiply the fill color once. Only the background is multiplied per pixel*/
+            uint32_t fg_rb = (color.full & 0x00FF00FF) * opa;
+            uint32_t fg_g = (color.full & 0x0000FF00) * opa;
+            uint32_t opa_inv = 255 - opa;
+            uint32_t bg_tmp = 0;
+            uint32_t opa_tmp = px32_mix_pre(bg_tmp, fg_rb, fg_g, opa_inv);
+            for(row = fill_area->y1; row <= fill_area->y2; row++) {
+                uint32_t * m32 = (uint32_t *)mem;
+                for(col = fill_area->x1; col <= fill_area->x2; col++) {
+                    /*If the bg color changed recalculate the result color*/
+                    if(m32[col] != bg_tmp) {
+                        bg_tmp = m32[col];
+                        opa_tmp = px32_mix_pre(bg_tmp, fg_rb, fg_g, opa_inv);
+                    }
+                    m32[col] = opa_tmp;
+                }
+                mem += mem_width;
+            }
+#else
 #if LV_COLOR_SCREEN_TRANSP == 0
             lv_color_t bg_tmp = LV_COLOR_BLACK;
             lv_color_t opa_tmp = lv_color_mix(color, bg_tmp, opa);
@@ -634,10 +696,112 @@ static void sw_color_fill(lv_area_t * mem_area, lv_color_t * mem, const lv_area_
                 }
                 mem += mem_width;
             }
+#endif
+        }
+    }
+}
+
+#if VBASIC_PX32
+
+/**
+ * Fill pixels with a color using aligned 2 pixel stores
+ * @param dest a memory address
+ * @param color fill color
+ * @param length number of pixels to fill
+ */
+static inline void px32_fill(uint32_t * dest, uint32_t color, uint32_t length)
+{
+    if(((uintptr_t)dest & 4) && length) {
+        *dest++ = color;
+        length--;
+    }
+
+    uint64_t color2 = ((uint64_t)color << 32) | color;
+    uint64_t * d64 = (uint64_t *)dest;
+    while(length >= 8) {
+        d64[0] = color2;
+        d64[1] = color2;
+        d64[2] = color2;
+        d64[3] = color2;
+        d64 += 4;
+        length -= 8;
+    }
+    while(length >= 2) {
+        *d64++ = color2;
+        length -= 2;
+    }
+
+    if(length) *(uint32_t *)d64 = color;
+}
+
+/**
+ * Mix a premultiplied foreground to a background. Red and blue are calculated together.
+ * Gives the same result as 'lv_color_mix'.
+ * @param bg background color
+ * @param fg_rb red and blue channels of the foreground multiplied by its opacity
+ * @param fg_g green channel of the foreground multiplied by its opacity
+ * @param opa_inv 255 - foreground opacity
+ * @return the mixed color
+ */
+static inline uint32_t px32_mix_pre(uint32_t bg, uint32_t fg_rb, uint32_t fg_g, uint32_t opa_inv)
+{
+    uint32_t rb = (fg_rb + (bg & 0x00FF00FF) * opa_inv) >> 8;
+    uint32_t g = (fg_g + (bg & 0x0000FF00) * opa_inv) >> 8;
+
+    return 0xFF000000 | (rb & 0x00FF00FF) | (g & 0x0000FF00);
+}
+
+/**
+ * Mix two colors with paired channels
+ * @param fg foreground color
+ * @param bg background color
+ * @param opa opacity of the foreground
+ * @return the mixed color
+ */
+static inline uint32_t px32_mix(uint32_t fg, uint32_t bg, uint32_t opa)
+{
+    return px32_mix_pre(bg, (fg & 0x00FF00FF) * opa, (fg & 0x0000FF00) * opa, 255 - opa);
+}
+
+/**
+ * Blend an image row which has alpha in its pixels
+ * @param dest a memory address. Blend 'src' here.
+ * @param src pointer to ARGB8888 pixels
+ * @param length number of pixels in 'src'
+ * @param opa opacity of the whole image
+ */
+static void px32_map_alpha(uint32_t * dest, const uint32_t * src, uint32_t length, lv_opa_t opa)
+{
+    uint32_t col = 0;
+
+    while(col < length) {
+        /*Copy runs of opaque pixels at once*/
+        if(opa == LV_OPA_COVER) {
+            uint32_t run = col;
+            while(run < length && (src[run] >> 24) == LV_OPA_COVER) run++;
+
+            if(run != col) {
+                memcpy(&dest[col], &src[col], (run - col) * sizeof(uint32_t));
+                col = run;
+                if(col == length) break;
+            }
         }
+
+        uint32_t px = src[col];
+        uint32_t px_opa = px >> 24;
+        if(px_opa != LV_OPA_TRANSP) {
+            if(px_opa != LV_OPA_COVER) px_opa = (px_opa * opa) >> 8;
+            else px_opa = opa;
+
+            if(px_opa == LV_OPA_COVER) dest[col] = px;
+            else dest[col] = px32_mix(px, dest[col], px_opa);
+        }
+        col++;
     }
 }
 
+#endif /*VBASIC_PX32*/
+
 #if LV_COLOR_SCREEN_TRANSP
 
 /**
@@ -230,7 +230,7 @@ lv_font_t ubuntu_mono =
     .unicode_last = 126,	/*Last Unicode letter in this font*/
     .h_px = 20,				/*Font height in pixels*/
     //.glyph_bitmap = ubuntu_mono_glyph_bitmap,	/*Bitmap of glyphs*/
-    .glyph_bitmap = (const uint8_t *)(NYX_RES_ADDR),
+    .glyph_bitmap = (const uint8_t *)(NYX_RES_ADDR + NYX_RES_UBUNTU_MONO_OFF),
     .glyph_dsc = ubuntu_mono_glyph_dsc,		/*Description of glyphs*/
     .glyph_cnt = 95,			/*Number of glyphs in the font*/
     .unicode_list = NULL,	/*Every character in the font from 'unicode_first' to 'unicode_last'*/
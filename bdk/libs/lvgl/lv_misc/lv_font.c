@@ -25,6 +25,7 @@
 /**********************
  *  STATIC VARIABLES
  **********************/
+static void (*bitmap_cb)(const lv_font_t *);
 
 /**********************
  * GLOBAL PROTOTYPES
@@ -63,6 +64,16 @@ void lv_font_add(lv_font_t * child, lv_font_t * parent)
 
 }
 
+/**
+ * Set a callback which is called before the glyph bitmap of a font is used.
+ * It allows glyph bitmaps to be loaded on demand.
+ * @param cb the callback or NULL to disable it
+ */
+void lv_font_set_bitmap_cb(void (*cb)(const lv_font_t *))
+{
+    bitmap_cb = cb;
+}
+
 /**
  * Remove a font from a character set.
  * @param child the font to remove
@@ -115,6 +126,7 @@ const uint8_t * lv_font_get_bitmap(const lv_font_t * font_p, uint32_t letter)
 {
     const lv_font_t * font_i = font_p;
     while(font_i != NULL) {
+        if(bitmap_cb) bitmap_cb(font_i);
         const uint8_t * bitmap = font_i->get_bitmap(font_i, letter);
         if(bitmap) return bitmap;
 
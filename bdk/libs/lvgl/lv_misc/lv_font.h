@@ -77,6 +77,13 @@ void lv_font_init(void);
  */
 void lv_font_add(lv_font_t *child, lv_font_t *parent);
 
+/**
+ * Set a callback which is called before the glyph bitmap of a font is used.
+ * It allows glyph bitmaps to be loaded on demand.
+ * @param cb the callback or NULL to disable it
+ */
+void lv_font_set_bitmap_cb(void (*cb)(const lv_font_t *));
+
 /**
  * Remove a font from a character set.
  * @param child the font to remove
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022 CTCaer
+ * Copyright (c) 2019-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -21,10 +21,14 @@
 
 #include <ianos/ianos.h>
 #include <mem/emc.h>
+#include <soc/bpmp.h>
 #include <soc/clock.h>
 #include <soc/fuse.h>
 #include <soc/hw_init.h>
 #include <soc/t210.h>
+#include <storage/sd.h>
+#include <thermal/tmp451.h>
+#include <utils/trace.h>
 #include <utils/util.h>
 
 #define LA_REGS_OFFSET_T210    0x1284
@@ -32,13 +36,185 @@
 #define LA_SDMMC1_INDEX 6
 #define LA_SDMMC4_INDEX 9
 
+#define MTC_CACHE_PATH    "bootloader/sys/mtc_cache.bin"
+#define MTC_CACHE_MAGIC   0x4843544D // MTCH.
+#define MTC_CACHE_VERSION 1
+
+#define MTC_CACHE_TEMP_DELTA 15  // oC.
+#define MTC_CACHE_TEMP_MAX   100 // oC. Higher is saturated or bogus.
+
+#define MTC_TEST_WORDS (SZ_256K / sizeof(u32))
+
+typedef struct _mtc_cache_hdr_t
+{
+	u32 magic;
+	u32 version;
+	u32 sdram_id;
+	u32 hidrev;
+	u32 base_crc32; // CRC32 of the untrained module table.
+	u32 soc_temp;
+	u32 table_entries;
+	u32 entry_size;
+	u32 crc32;      // CRC32 of the trained table.
+} mtc_cache_hdr_t;
+
 extern volatile nyx_storage_t *nyx_str;
 
 void (*minerva_cfg)(mtc_config_t *mtc_cfg, void *);
 
+static bool _minerva_soc_temp(u32 *temp)
+{
+	// Hekate does not own the sensor. A previous session may have left it in shutdown or another config.
+	if (!tmp451_is_configured())
+	{
+		// Conversion result is stale until the first conversion completes.
+		tmp451_init();
+		return false;
+	}
+
+	// A failed read returns 0.
+	*temp = tmp451_get_soc_temp(true);
+
+	return *temp && *temp < MTC_CACHE_TEMP_MAX;
+}
+
+static bool _minerva_cache_key(mtc_config_t *mtc_cfg, mtc_cache_hdr_t *key)
+{
+	memset(key, 0, sizeof(mtc_cache_hdr_t));
+
+	key->magic         = MTC_CACHE_MAGIC;
+	key->version       = MTC_CACHE_VERSION;
+	key->sdram_id      = mtc_cfg->sdram_id;
+	key->hidrev        = APB_MISC(APB_MISC_GP_HIDREV);
+	key->table_entries = mtc_cfg->table_entries;
+	key->entry_size    = sizeof(emc_table_t);
+
+	// Any module or table patch change invalidates the cache.
+	key->base_crc32 = crc32_calc(0, (u8 *)mtc_cfg->mtc_table, key->table_entries * key->entry_size);
+
+	// Without a valid temperature the cached trimmers can't be matched.
+	return _minerva_soc_temp(&key->soc_temp);
+}
+
+static bool _minerva_cache_load(mtc_config_t *mtc_cfg, const mtc_cache_hdr_t *key)
+{
+	u32 fsize = 0;
+	u32 table_size = key->table_entries * key->entry_size;
+
+	mtc_cache_hdr_t *hdr = (mtc_cache_hdr_t *)sd_file_read(MTC_CACHE_PATH, &fsize);
+	if (!hdr)
+		return false;
+
+	bool valid = fsize == (sizeof(mtc_cache_hdr_t) + table_size) &&
+				 hdr->magic         == key->magic         &&
+				 hdr->version       == key->version       &&
+				 hdr->sdram_id      == key->sdram_id      &&
+				 hdr->hidrev        == key->hidrev        &&
+				 hdr->base_crc32    == key->base_crc32    &&
+				 hdr->table_entries == key->table_entries &&
+				 hdr->entry_size    == key->entry_size;
+
+	// Training is temperature sensitive. Retrain if it drifted too much.
+	int temp_delta = (int)hdr->soc_temp - (int)key->soc_temp;
+	if (temp_delta < 0)
+		temp_delta = -temp_delta;
+	if (temp_delta > MTC_CACHE_TEMP_DELTA)
+		valid = false;
+
+	emc_table_t *table = (emc_table_t *)((u8 *)hdr + sizeof(mtc_cache_hdr_t));
+	if (valid)
+		valid = hdr->crc32 == crc32_calc(0, (u8 *)table, table_size);
+
+	// Only accept tables with all boot frequencies trained.
+	for (u32 i = 0; valid && i < hdr->table_entries; i++)
+	{
+		u32 rate = table[i].rate_khz;
+		if ((rate == FREQ_204 || rate == FREQ_800 || rate == FREQ_1600) && !table[i].trained)
+			valid = false;
+	}
+
+	if (valid)
+		memcpy(mtc_cfg->mtc_table, table, table_size);
+
+	free(hdr);
+
+	return valid;
+}
+
+static void _minerva_cache_save(mtc_config_t *mtc_cfg, mtc_cache_hdr_t *key)
+{
+	// Store the temperature at the end of training. Skip if it's not valid.
+	if (!_minerva_soc_temp(&key->soc_temp))
+		return;
+
+	u32 table_size = key->table_entries * key->entry_size;
+	u8 *buf = malloc(sizeof(mtc_cache_hdr_t) + table_size);
+
+	key->crc32 = crc32_calc(0, (u8 *)mtc_cfg->mtc_table, table_size);
+	memcpy(buf, key, sizeof(mtc_cache_hdr_t));
+	memcpy(buf + sizeof(mtc_cache_hdr_t), mtc_cfg->mtc_table, table_size);
+
+	sd_save_to_file(buf, sizeof(mtc_cache_hdr_t) + table_size, MTC_CACHE_PATH);
+
+	free(buf);
+}
+
+static bool _minerva_dram_test()
+{
+	u32 *buf = malloc(MTC_TEST_WORDS * sizeof(u32));
+	bool passed = true;
+
+	// Address and inverted address patterns, to catch stuck and swapped bits.
+	for (u32 pass = 0; pass < 2 && passed; pass++)
+	{
+		u32 xor = pass ? 0xFFFFFFFF : 0;
+
+		for (u32 i = 0; i < MTC_TEST_WORDS; i++)
+			buf[i] = ((u32)&buf[i]) ^ xor;
+
+		// Make sure that data are read back from DRAM.
+		bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLN_INV_WAY, false);
+
+		for (u32 i = 0; i < MTC_TEST_WORDS; i++)
+		{
+			if (buf[i] != (((u32)&buf[i]) ^ xor))
+			{
+				passed = false;
+				break;
+			}
+		}
+	}
+
+	free(buf);
+
+	return passed;
+}
+
+static void _minerva_train(mtc_config_t *mtc_cfg, u32 rate_from)
+{
+	mtc_cfg->rate_from = rate_from;
+	mtc_cfg->rate_to = FREQ_204;
+	mtc_cfg->train_mode = OP_TRAIN;
+	minerva_cfg(mtc_cfg, NULL);
+	mtc_cfg->rate_to = FREQ_800;
+	minerva_cfg(mtc_cfg, NULL);
+	mtc_cfg->rate_to = FREQ_1600;
+	minerva_cfg(mtc_cfg, NULL);
+
+	// FSP WAR.
+	mtc_cfg->train_mode = OP_SWITCH;
+	mtc_cfg->rate_to = FREQ_800;
+	minerva_cfg(mtc_cfg, NULL);
+
+	// Switch to max.
+	mtc_cfg->rate_to = FREQ_1600;
+	minerva_cfg(mtc_cfg, NULL);
+}
+
 u32 minerva_init()
 {
 	u32 tbl_idx = 0;
+	mtc_cache_hdr_t cache_key;
 
 	minerva_cfg = NULL;
 	mtc_config_t *mtc_cfg = (mtc_config_t *)&nyx_str->mtc_cfg;
@@ -109,23 +285,34 @@ u32 minerva_init()
 			break;
 	}
 
-	mtc_cfg->rate_from = mtc_cfg->mtc_table[tbl_idx].rate_khz;
-	mtc_cfg->rate_to = FREQ_204;
-	mtc_cfg->train_mode = OP_TRAIN;
-	minerva_cfg(mtc_cfg, NULL);
-	mtc_cfg->rate_to = FREQ_800;
-	minerva_cfg(mtc_cfg, NULL);
-	mtc_cfg->rate_to = FREQ_1600;
-	minerva_cfg(mtc_cfg, NULL);
+	// Try to skip training by using a previously trained table.
+	bool cached = _minerva_cache_key(mtc_cfg, &cache_key) && _minerva_cache_load(mtc_cfg, &cache_key);
 
-	// FSP WAR.
-	mtc_cfg->train_mode = OP_SWITCH;
-	mtc_cfg->rate_to = FREQ_800;
-	minerva_cfg(mtc_cfg, NULL);
+	TRACE_BEGIN("minerva_train");
 
-	// Switch to max.
-	mtc_cfg->rate_to = FREQ_1600;
-	minerva_cfg(mtc_cfg, NULL);
+	// Trained entries are only switched to.
+	_minerva_train(mtc_cfg, mtc_cfg->mtc_table[tbl_idx].rate_khz);
+
+	if (cached)
+	{
+		// Validate cached trimmers. On failure, reload the stock table and do a full training.
+		if (!_minerva_dram_test())
+		{
+			minerva_change_freq(FREQ_204);
+
+			mtc_cfg->init_done = MTC_NEW_MAGIC;
+			minerva_cfg(mtc_cfg, NULL);
+
+			_minerva_train(mtc_cfg, FREQ_204);
+			_minerva_cache_save(mtc_cfg, &cache_key);
+		}
+		else
+			minerva_periodic_training(); // Compensate any drift from the cached trimmers.
+	}
+	else
+		_minerva_cache_save(mtc_cfg, &cache_key);
+
+	TRACE_END("minerva_train");
 
 	return 0;
 }
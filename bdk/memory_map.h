@@ -77,9 +77,25 @@
 
 // Nyx buffers.
 #define NYX_STORAGE_ADDR 0xED000000
+#define IANOS_CACHE_ADDR 0xEDC00000 // Relocated ianos modules. Survives Nyx.
+#define  IANOS_CACHE_SZ        SZ_2M
+#define SDMMC_ADMA_ADDR  0xEDE00000 // ADMA2 descriptor tables.
+#define  SDMMC_ADMA_SZ        SZ_64K
+#define BOOT_TRACE_ADDR  0xEDFF0000 // Boot profiler ring buffer. Survives chainloading and Nyx.
+#define  BOOT_TRACE_SZ        SZ_64K
 #define NYX_RES_ADDR     0xEE000000
 #define  NYX_RES_SZ          SZ_16M
 
+// res.pak layout. Fonts, logos and the Nyx pager use these. Each resource ends where the next one starts.
+#define  NYX_RES_UBUNTU_MONO_OFF       0x00000
+#define  NYX_RES_INTERUI_20_OFF        0x03A00
+#define  NYX_RES_INTERUI_30_OFF        0x07900
+#define  NYX_RES_HEKATE_SYMBOL_20_OFF  0x0FC00
+#define  NYX_RES_HEKATE_SYMBOL_30_OFF  0x14200
+#define  NYX_RES_HEKATE_LOGO_OFF       0x1D900
+#define  NYX_RES_CTCAER_LOGO_OFF       0x2BF00
+#define  NYX_RES_HEKATE_SYMBOL_120_OFF 0x36E00
+
 // SDMMC DMA buffers 2
 #define SDXC_BUF_ALIGNED   0xEF000000
 #define MIXD_BUF_ALIGNED   0xF0000000
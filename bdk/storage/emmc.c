@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2018 naehrwert
- * Copyright (c) 2019-2022 CTCaer
+ * Copyright (c) 2019-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -25,6 +25,26 @@
 
 static u16 emmc_errors[3] = { 0 }; // Init and Read/Write errors.
 static u32 emmc_mode = EMMC_MMC_HS400;
+static bool emmc_init_pending = false;
+static sdmmc_storage_init_t emmc_init_ctx;
+
+typedef struct _emmc_cache_line_t
+{
+	u32 dev;
+	u32 part;
+	u32 sector; // Line aligned.
+	u32 used;   // Last use stamp. 0 if free.
+} emmc_cache_line_t;
+
+typedef struct _emmc_cache_t
+{
+	u32 stamp;
+	emmc_cache_line_t lines[EMMC_CACHE_LINES];
+	u8 *data;
+	u8 *fill_buf;
+} emmc_cache_t;
+
+static emmc_cache_t *emmc_cache = NULL;
 
 sdmmc_t emmc_sdmmc;
 sdmmc_storage_t emmc_storage;
@@ -61,47 +81,95 @@ u32 emmc_get_mode()
 	return emmc_mode;
 }
 
-void emmc_end() { sdmmc_storage_end(&emmc_storage); }
-
-int emmc_init_retry(bool power_cycle)
+void emmc_end()
 {
-	u32 bus_width = SDMMC_BUS_WIDTH_8;
-	u32 type = SDHCI_TIMING_MMC_HS400;
-
-	// Power cycle SD eMMC.
-	if (power_cycle)
+	// Cancel any deferred init.
+	if (emmc_init_pending)
 	{
-		emmc_mode--;
-		emmc_end();
+		sdmmc_storage_init_set_background(NULL);
+		emmc_init_pending = false;
 	}
 
+	sdmmc_storage_end(&emmc_storage);
+}
+
+void emmc_end_deferred()
+{
+	// Power down an eMMC started at boot that no one used.
+	if (emmc_init_pending || emmc_storage.initialized)
+		emmc_end();
+}
+
+static int _emmc_get_init_params(u32 *bus_width, u32 *type)
+{
+	*bus_width = SDMMC_BUS_WIDTH_8;
+	*type = SDHCI_TIMING_MMC_HS400;
+
 	// Get init parameters.
 	switch (emmc_mode)
 	{
 	case EMMC_INIT_FAIL: // Reset to max.
 		return 0;
 	case EMMC_1BIT_HS52:
-		bus_width = SDMMC_BUS_WIDTH_1;
-		type = SDHCI_TIMING_MMC_HS52;
+		*bus_width = SDMMC_BUS_WIDTH_1;
+		*type = SDHCI_TIMING_MMC_HS52;
 		break;
 	case EMMC_8BIT_HS52:
-		type = SDHCI_TIMING_MMC_HS52;
+		*type = SDHCI_TIMING_MMC_HS52;
 		break;
 	case EMMC_MMC_HS200:
-		type = SDHCI_TIMING_MMC_HS200;
+		*type = SDHCI_TIMING_MMC_HS200;
 		break;
 	case EMMC_MMC_HS400:
-		type = SDHCI_TIMING_MMC_HS400;
+		*type = SDHCI_TIMING_MMC_HS400;
 		break;
 	default:
 		emmc_mode = EMMC_MMC_HS400;
 	}
 
+	return 1;
+}
+
+int emmc_init_retry(bool power_cycle)
+{
+	u32 bus_width, type;
+
+	// Power cycle SD eMMC.
+	if (power_cycle)
+	{
+		emmc_mode--;
+		emmc_end();
+	}
+
+	if (!_emmc_get_init_params(&bus_width, &type))
+		return 0;
+
 	return sdmmc_storage_init_mmc(&emmc_storage, &emmc_sdmmc, bus_width, type);
 }
 
+static bool _emmc_init_retries()
+{
+	while (true)
+	{
+		emmc_errors[EMMC_ERROR_INIT_FAIL]++;
+
+		if (emmc_mode == EMMC_INIT_FAIL)
+			break;
+		else if (emmc_init_retry(true))
+			return true;
+	}
+
+	emmc_end();
+
+	return false;
+}
+
 bool emmc_initialize(bool power_cycle)
 {
+	// Finish a deferred init started at boot.
+	if (!power_cycle && emmc_init_pending)
+		return emmc_initialize_finish();
+
 	// Reset mode in case of previous failure.
 	if (emmc_mode == EMMC_INIT_FAIL)
 		emmc_mode = EMMC_MMC_HS400;
@@ -109,29 +177,178 @@ bool emmc_initialize(bool power_cycle)
 	if (power_cycle)
 		emmc_end();
 
-	int res = !emmc_init_retry(false);
+	if (emmc_init_retry(false))
+		return true;
 
-	while (true)
+	return _emmc_init_retries();
+}
+
+void emmc_initialize_start()
+{
+	u32 bus_width, type;
+
+	// Already started.
+	if (emmc_init_pending)
+		return;
+
+	// Reset mode in case of previous failure.
+	if (emmc_mode == EMMC_INIT_FAIL)
+		emmc_mode = EMMC_MMC_HS400;
+
+	_emmc_get_init_params(&bus_width, &type);
+
+	// Let other storage inits advance it while they wait for their cards.
+	sdmmc_storage_init_mmc_start(&emmc_init_ctx, &emmc_storage, &emmc_sdmmc, bus_width, type);
+	sdmmc_storage_init_set_background(&emmc_init_ctx);
+	emmc_init_pending = true;
+}
+
+bool emmc_initialize_finish()
+{
+	if (!emmc_init_pending)
+		return emmc_storage.initialized ? true : emmc_initialize(false);
+
+	emmc_init_pending = false;
+	if (sdmmc_storage_init_run(&emmc_init_ctx))
+		return true;
+
+	return _emmc_init_retries();
+}
+
+int emmc_set_partition(u32 partition)
+{
+	// Skip needless switches.
+	if (emmc_storage.initialized && emmc_storage.partition == partition)
+		return 1;
+
+	return sdmmc_storage_set_mmc_partition(&emmc_storage, partition);
+}
+
+static int _emmc_cache_find(u32 dev, u32 part, u32 sector)
+{
+	for (u32 i = 0; i < EMMC_CACHE_LINES; i++)
 	{
-		if (!res)
-			return true;
+		emmc_cache_line_t *line = &emmc_cache->lines[i];
+		if (line->used && line->sector == sector && line->part == part && line->dev == dev)
+			return i;
+	}
+
+	return -1;
+}
+
+static int _emmc_cache_evict()
+{
+	// Get a free or the least recently used line.
+	u32 idx = 0;
+	for (u32 i = 1; i < EMMC_CACHE_LINES; i++)
+		if (emmc_cache->lines[i].used < emmc_cache->lines[idx].used)
+			idx = i;
+
+	return idx;
+}
+
+int emmc_cache_read(u32 dev, u32 part, u32 sector, u32 num_sectors, void *buf, emmc_cache_read_t read)
+{
+	int idx[EMMC_CACHE_MAX_SCT / EMMC_CACHE_LINE_SCT + 1];
+	u8 *out = (u8 *)buf;
+
+	if (!num_sectors || num_sectors > EMMC_CACHE_MAX_SCT)
+		return read(sector, num_sectors, buf);
+
+	if (!emmc_cache)
+	{
+		emmc_cache = (emmc_cache_t *)calloc(sizeof(emmc_cache_t), 1);
+		emmc_cache->data     = (u8 *)malloc(EMMC_CACHE_LINES * EMMC_CACHE_LINE_SCT * EMMC_BLOCKSIZE);
+		emmc_cache->fill_buf = (u8 *)malloc(ARRAY_SIZE(idx) * EMMC_CACHE_LINE_SCT * EMMC_BLOCKSIZE);
+	}
+
+	u32 first    = ALIGN_DOWN(sector, EMMC_CACHE_LINE_SCT);
+	u32 line_cnt = (ALIGN_DOWN(sector + num_sectors - 1, EMMC_CACHE_LINE_SCT) - first) / EMMC_CACHE_LINE_SCT + 1;
+	bool hit = true;
+
+	// Look up and refresh all lines of the span.
+	for (u32 i = 0; i < line_cnt; i++)
+	{
+		idx[i] = _emmc_cache_find(dev, part, first + i * EMMC_CACHE_LINE_SCT);
+		if (idx[i] < 0)
+			hit = false;
 		else
+			emmc_cache->lines[idx[i]].used = ++emmc_cache->stamp;
+	}
+
+	if (hit)
+	{
+		for (u32 i = 0; i < line_cnt; i++)
 		{
-			emmc_errors[EMMC_ERROR_INIT_FAIL]++;
+			u32 line_sct = first + i * EMMC_CACHE_LINE_SCT;
+			u32 offset   = (sector > line_sct) ? sector - line_sct : 0;
+			u32 count    = MIN(EMMC_CACHE_LINE_SCT - offset, sector + num_sectors - (line_sct + offset));
 
-			if (emmc_mode == EMMC_INIT_FAIL)
-				break;
-			else
-				res = !emmc_init_retry(true);
+			memcpy(out, emmc_cache->data + (idx[i] * EMMC_CACHE_LINE_SCT + offset) * EMMC_BLOCKSIZE, count * EMMC_BLOCKSIZE);
+			out += count * EMMC_BLOCKSIZE;
 		}
+
+		return 1;
 	}
 
-	emmc_end();
+	// Fill the whole span with one transfer. Fall back to an uncached read if it goes past the end.
+	if (!read(first, line_cnt * EMMC_CACHE_LINE_SCT, emmc_cache->fill_buf))
+		return read(sector, num_sectors, buf);
 
-	return false;
+	for (u32 i = 0; i < line_cnt; i++)
+	{
+		if (idx[i] >= 0)
+			continue;
+
+		idx[i] = _emmc_cache_evict();
+
+		emmc_cache_line_t *line = &emmc_cache->lines[idx[i]];
+		line->dev    = dev;
+		line->part   = part;
+		line->sector = first + i * EMMC_CACHE_LINE_SCT;
+		line->used   = ++emmc_cache->stamp;
+
+		memcpy(emmc_cache->data + idx[i] * EMMC_CACHE_LINE_SCT * EMMC_BLOCKSIZE,
+			   emmc_cache->fill_buf + i * EMMC_CACHE_LINE_SCT * EMMC_BLOCKSIZE, EMMC_CACHE_LINE_SCT * EMMC_BLOCKSIZE);
+	}
+
+	memcpy(buf, emmc_cache->fill_buf + (sector - first) * EMMC_BLOCKSIZE, num_sectors * EMMC_BLOCKSIZE);
+
+	return 1;
 }
 
-int emmc_set_partition(u32 partition) { return sdmmc_storage_set_mmc_partition(&emmc_storage, partition); }
+void emmc_cache_invalidate(u32 dev, u32 part, u32 sector, u32 num_sectors)
+{
+	if (!emmc_cache)
+		return;
+
+	for (u32 i = 0; i < EMMC_CACHE_LINES; i++)
+	{
+		emmc_cache_line_t *line = &emmc_cache->lines[i];
+		if (line->used && line->dev == dev && line->part == part &&
+			line->sector < (sector + num_sectors) && sector < (line->sector + EMMC_CACHE_LINE_SCT))
+		{
+			line->used = 0;
+		}
+	}
+}
+
+void emmc_cache_reset()
+{
+	// Buffers are kept, since a line fill can be in flight across an error recovery reinit.
+	if (emmc_cache)
+		memset(emmc_cache->lines, 0, sizeof(emmc_cache->lines));
+}
+
+static int _emmc_read(u32 sector, u32 num_sectors, void *buf)
+{
+	return sdmmc_storage_read(&emmc_storage, sector, num_sectors, buf);
+}
+
+int emmc_read_cached(u32 sector, u32 num_sectors, void *buf)
+{
+	return emmc_cache_read(EMMC_CACHE_DEV_EMMC, emmc_storage.partition, sector, num_sectors, buf, _emmc_read);
+}
 
 void emmc_gpt_parse(link_t *gpt)
 {
@@ -140,7 +357,7 @@ void emmc_gpt_parse(link_t *gpt)
 #ifdef BDK_EMUMMC_ENABLE
 	emummc_storage_read(GPT_FIRST_LBA, GPT_NUM_BLOCKS, gpt_buf);
 #else
-	sdmmc_storage_read(&emmc_storage, GPT_FIRST_LBA, GPT_NUM_BLOCKS, gpt_buf);
+	emmc_read_cached(GPT_FIRST_LBA, GPT_NUM_BLOCKS, gpt_buf);
 #endif
 
 	// Check if no GPT or more than max allowed entries.
@@ -208,6 +425,8 @@ int emmc_part_write(emmc_part_t *part, u32 sector_off, u32 num_sectors, void *bu
 #ifdef BDK_EMUMMC_ENABLE
 	return emummc_storage_write(part->lba_start + sector_off, num_sectors, buf);
 #else
+	emmc_cache_invalidate(EMMC_CACHE_DEV_EMMC, emmc_storage.partition, part->lba_start + sector_off, num_sectors);
+
 	return sdmmc_storage_write(&emmc_storage, part->lba_start + sector_off, num_sectors, buf);
 #endif
 }
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2018 naehrwert
- * Copyright (c) 2019-2022 CTCaer
+ * Copyright (c) 2019-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -28,6 +28,11 @@
 #define GPT_NUM_BLOCKS 33
 #define EMMC_BLOCKSIZE 512
 
+/*! Raw block cache for small metadata reads. */
+#define EMMC_CACHE_LINE_SCT 8  // 4KB lines.
+#define EMMC_CACHE_LINES    32
+#define EMMC_CACHE_MAX_SCT  64 // Bigger reads bypass the cache.
+
 enum
 {
 	EMMC_INIT_FAIL = 0,
@@ -44,6 +49,14 @@ enum
 	EMMC_ERROR_RW_RETRY  = 2
 };
 
+enum
+{
+	EMMC_CACHE_DEV_EMMC   = 0,
+	EMMC_CACHE_DEV_EMUMMC = 1
+};
+
+typedef int (*emmc_cache_read_t)(u32 sector, u32 num_sectors, void *buf);
+
 typedef struct _emmc_part_t
 {
 	u32 index;
@@ -63,8 +76,16 @@ u16 *emmc_get_error_count();
 u32  emmc_get_mode();
 int  emmc_init_retry(bool power_cycle);
 bool emmc_initialize(bool power_cycle);
+void emmc_initialize_start();
+bool emmc_initialize_finish();
 int  emmc_set_partition(u32 partition);
 void emmc_end();
+void emmc_end_deferred();
+
+int  emmc_cache_read(u32 dev, u32 part, u32 sector, u32 num_sectors, void *buf, emmc_cache_read_t read);
+void emmc_cache_invalidate(u32 dev, u32 part, u32 sector, u32 num_sectors);
+void emmc_cache_reset();
+int  emmc_read_cached(u32 sector, u32 num_sectors, void *buf);
 
 void emmc_gpt_parse(link_t *gpt);
 void emmc_gpt_free(link_t *gpt);
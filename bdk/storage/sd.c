@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2018 naehrwert
- * Copyright (c) 2018-2023 CTCaer
+ * Copyright (c) 2018-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -19,6 +19,8 @@
 #include <storage/sdmmc.h>
 #include <storage/sdmmc_driver.h>
 #include <gfx_utils.h>
+#include <libs/compr/lz4.h>
+#include <libs/compr/lz4c.h>
 #include <libs/fatfs/ff.h>
 #include <mem/heap.h>
 
@@ -32,6 +34,7 @@ static bool sd_mounted = false;
 static bool sd_init_done = false;
 static bool insertion_event = false;
 static u16  sd_errors[3] = { 0 }; // Init and Read/Write errors.
+static u16  sd_mode_errors[SD_MODE_NUM] = { 0 }; // Read/Write errors per SD mode.
 static u32  sd_mode = SD_DEFAULT_SPEED;
 
 
@@ -51,6 +54,7 @@ void sd_error_count_increment(u8 type)
 		break;
 	case SD_ERROR_RW_RETRY:
 		sd_errors[2]++;
+		sd_mode_errors[sd_mode]++;
 		break;
 	}
 }
@@ -60,6 +64,11 @@ u16 *sd_get_error_count()
 	return sd_errors;
 }
 
+u16 *sd_get_mode_error_count()
+{
+	return sd_mode_errors;
+}
+
 bool sd_get_card_removed()
 {
 	if (insertion_event && !sdmmc_get_sd_inserted())
@@ -274,6 +283,97 @@ void *sd_file_read(const char *path, u32 *fsize)
 	return buf;
 }
 
+void *sd_file_read_lz4c(const char *path, void *buf, u32 buf_size, u32 *fsize)
+{
+	FIL fp;
+	lz4c_hdr_t hdr;
+	u32 *csizes = NULL;
+	u8 *cbuf = NULL;
+	u8 *dst = NULL;
+
+	if (!sd_get_card_mounted())
+		return NULL;
+
+	if (f_open(&fp, path, FA_READ) != FR_OK)
+		return NULL;
+
+	// Check if file is LZ4 chunked. Otherwise read it as is.
+	u32 size = f_size(&fp);
+	bool compressed = size > sizeof(lz4c_hdr_t) &&
+					  f_read(&fp, &hdr, sizeof(lz4c_hdr_t), NULL) == FR_OK &&
+					  hdr.magic == LZ4C_MAGIC;
+	if (!compressed)
+	{
+		f_lseek(&fp, 0);
+		hdr.size = size;
+	}
+
+	// Destination must be allocated first, so it gets the same address as an uncompressed read.
+	if (buf && hdr.size > buf_size)
+		goto error;
+	dst = buf ? buf : malloc(hdr.size);
+
+	if (!compressed)
+	{
+		if (f_read(&fp, dst, size, NULL) != FR_OK)
+			goto error;
+
+		goto out;
+	}
+
+	// Sanity check header.
+	if (!hdr.chunk_size || hdr.chunk_size > LZ4C_CHUNK_SIZE_MAX ||
+		hdr.chunks != (hdr.size + hdr.chunk_size - 1) / hdr.chunk_size)
+		goto error;
+
+	// Read compressed sizes table.
+	csizes = malloc(hdr.chunks * sizeof(u32));
+	if (f_read(&fp, csizes, hdr.chunks * sizeof(u32), NULL) != FR_OK)
+		goto error;
+
+	// Read and decompress chunk by chunk. Compressed chunks are never bigger than uncompressed ones.
+	cbuf = malloc(hdr.chunk_size);
+	for (u32 i = 0; i < hdr.chunks; i++)
+	{
+		u32 offset = i * hdr.chunk_size;
+		u32 chunk_size = MIN(hdr.chunk_size, hdr.size - offset);
+
+		if (csizes[i] >= chunk_size)
+		{
+			// Stored chunk. Read it directly.
+			if (csizes[i] != chunk_size || f_read(&fp, dst + offset, chunk_size, NULL) != FR_OK)
+				goto error;
+		}
+		else
+		{
+			if (f_read(&fp, cbuf, csizes[i], NULL) != FR_OK)
+				goto error;
+
+			if (LZ4_decompress_safe((const char *)cbuf, (char *)dst + offset, csizes[i], chunk_size) != (int)chunk_size)
+				goto error;
+		}
+	}
+
+out:
+	if (fsize)
+		*fsize = hdr.size;
+
+	free(cbuf);
+	free(csizes);
+	f_close(&fp);
+
+	return dst;
+
+error:
+	if (!buf)
+		free(dst);
+	free(cbuf);
+	free(csizes);
+	f_close(&fp);
+
+	return NULL;
+}
+
 int sd_save_to_file(void *buf, u32 size, const char *filename)
 {
 	FIL fp;
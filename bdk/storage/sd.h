@@ -37,6 +37,8 @@ enum
 
 };
 
+#define SD_MODE_NUM 6
+
 enum
 {
 	SD_ERROR_INIT_FAIL = 0,
@@ -50,6 +52,7 @@ extern FATFS sd_fs;
 
 void sd_error_count_increment(u8 type);
 u16 *sd_get_error_count();
+u16 *sd_get_mode_error_count();
 bool sd_get_card_removed();
 bool sd_get_card_initialized();
 bool sd_get_card_mounted();
@@ -61,6 +64,7 @@ void sd_unmount();
 void sd_end();
 bool sd_is_gpt();
 void *sd_file_read(const char *path, u32 *fsize);
+void *sd_file_read_lz4c(const char *path, void *buf, u32 buf_size, u32 *fsize);
 int  sd_save_to_file(void *buf, u32 size, const char *filename);
 
 #endif
\ No newline at end of file
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2018 naehrwert
- * Copyright (c) 2018-2023 CTCaer
+ * Copyright (c) 2018-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -26,11 +26,20 @@
 #include <storage/sd_def.h>
 #include <memory_map.h>
 #include <gfx_utils.h>
+#include <utils/trace.h>
+#include <utils/util.h>
 
 //#define SDMMC_DEBUG_PRINT_SD_REGS
 //#define DPRINTF(...) gfx_printf(__VA_ARGS__)
 #define DPRINTF(...)
 
+#define SDMMC_XFER_MAX_SCT  0xFFFF
+#define SDMMC_XFER_MIN_SCT  8      // 4KB.
+#define SDMMC_XFER_GROW_CNT 4      // Successful transfers before growing again.
+#define SDMMC_RETRY_DELAY   5      // ms. Doubled on every retry.
+
+extern volatile nyx_storage_t *nyx_str;
+
 u32 sd_power_cycle_time_start;
 
 static inline u32 unstuff_bits(u32 *resp, u32 start, u32 size)
@@ -201,33 +210,162 @@ int sdmmc_storage_vendor_sandisk_report(sdmmc_storage_t *storage, void *buf)
 	return 1;
 }
 
-static int _sdmmc_storage_readwrite_ex(sdmmc_storage_t *storage, u32 *blkcnt_out, u32 sector, u32 num_sectors, void *buf, u32 is_write)
+void sdmmc_storage_tuning_cache_reset()
 {
-	u32 tmp = 0;
-	sdmmc_cmd_t cmdbuf;
-	sdmmc_req_t reqbuf;
+	sdmmc_tuning_cache_t *cache = (sdmmc_tuning_cache_t *)&nyx_str->sdmmc_tuning;
 
-	// If SDSC convert block address to byte address.
-	if (!storage->has_sector_access)
-		sector <<= 9;
+	memset(cache, 0, sizeof(sdmmc_tuning_cache_t));
+	cache->magic = SDMMC_TUNING_CACHE_MAGIC;
+}
 
-	sdmmc_init_cmd(&cmdbuf, is_write ? MMC_WRITE_MULTIPLE_BLOCK : MMC_READ_MULTIPLE_BLOCK, sector, SDMMC_RSP_TYPE_1, 0);
+static sdmmc_tuning_profile_t *_sdmmc_storage_tuning_find(const u8 *cid, u32 type)
+{
+	sdmmc_tuning_cache_t *cache = (sdmmc_tuning_cache_t *)&nyx_str->sdmmc_tuning;
 
-	reqbuf.buf              = buf;
-	reqbuf.num_sectors      = num_sectors;
-	reqbuf.blksize          = 512;
-	reqbuf.is_write         = is_write;
-	reqbuf.is_multi_block   = 1;
-	reqbuf.is_auto_stop_trn = 1;
+	if (cache->magic != SDMMC_TUNING_CACHE_MAGIC || cache->count > SDMMC_TUNING_PROFILES)
+		return NULL;
 
-	if (!sdmmc_execute_cmd(storage->sdmmc, &cmdbuf, &reqbuf, blkcnt_out))
+	for (u32 i = 0; i < cache->count; i++)
 	{
-		sdmmc_stop_transmission(storage->sdmmc, &tmp);
-		_sdmmc_storage_get_status(storage, &tmp, 0);
+		sdmmc_tuning_profile_t *prof = &cache->profiles[i];
+		if (prof->type == type && !memcmp(prof->cid, cid, sizeof(prof->cid)))
+			return prof;
+	}
+
+	return NULL;
+}
+
+int sdmmc_storage_tuning_cache_add(const sdmmc_tuning_profile_t *prof, bool replace)
+{
+	sdmmc_tuning_cache_t *cache = (sdmmc_tuning_cache_t *)&nyx_str->sdmmc_tuning;
+
+	if (cache->magic != SDMMC_TUNING_CACHE_MAGIC || cache->count > SDMMC_TUNING_PROFILES)
+		sdmmc_storage_tuning_cache_reset();
+
+	sdmmc_tuning_profile_t *entry = _sdmmc_storage_tuning_find(prof->cid, prof->type);
+	if (entry)
+	{
+		if (!replace || entry->tap == prof->tap)
+			return 0;
+
+		entry->tap = prof->tap;
+
+		return 1;
+	}
+
+	// Drop the oldest profile if full.
+	if (cache->count == SDMMC_TUNING_PROFILES)
+	{
+		memmove(&cache->profiles[0], &cache->profiles[1], sizeof(sdmmc_tuning_profile_t) * (SDMMC_TUNING_PROFILES - 1));
+		cache->count--;
+	}
+
+	memcpy(&cache->profiles[cache->count], prof, sizeof(sdmmc_tuning_profile_t));
+	cache->count++;
+
+	return 1;
+}
+
+void sdmmc_storage_tuning_drop_reset()
+{
+	sdmmc_tuning_drop_t *drop = (sdmmc_tuning_drop_t *)&nyx_str->sdmmc_tuning_drop;
+
+	memset(drop, 0, sizeof(sdmmc_tuning_drop_t));
+	drop->magic = SDMMC_TUNING_CACHE_MAGIC;
+}
+
+u32 sdmmc_storage_tuning_drop_count()
+{
+	sdmmc_tuning_drop_t *drop = (sdmmc_tuning_drop_t *)&nyx_str->sdmmc_tuning_drop;
 
+	if (drop->magic != SDMMC_TUNING_CACHE_MAGIC || drop->count > SDMMC_TUNING_PROFILES)
 		return 0;
+
+	return drop->count;
+}
+
+bool sdmmc_storage_tuning_dropped(const u8 *cid)
+{
+	sdmmc_tuning_drop_t *drop = (sdmmc_tuning_drop_t *)&nyx_str->sdmmc_tuning_drop;
+
+	for (u32 i = 0; i < sdmmc_storage_tuning_drop_count(); i++)
+	{
+		if (!memcmp(drop->cid[i], cid, sizeof(drop->cid[i])))
+			return true;
 	}
 
+	return false;
+}
+
+static void _sdmmc_storage_tuning_drop(sdmmc_storage_t *storage)
+{
+	sdmmc_tuning_cache_t *cache = (sdmmc_tuning_cache_t *)&nyx_str->sdmmc_tuning;
+	sdmmc_tuning_drop_t *drop = (sdmmc_tuning_drop_t *)&nyx_str->sdmmc_tuning_drop;
+
+	// Remember the card, so its saved profiles also get removed.
+	if (!sdmmc_storage_tuning_dropped(storage->raw_cid))
+	{
+		if (drop->magic != SDMMC_TUNING_CACHE_MAGIC || drop->count > SDMMC_TUNING_PROFILES)
+			sdmmc_storage_tuning_drop_reset();
+
+		// Forget the oldest card if full.
+		if (drop->count == SDMMC_TUNING_PROFILES)
+		{
+			memmove(drop->cid[0], drop->cid[1], sizeof(drop->cid[0]) * (SDMMC_TUNING_PROFILES - 1));
+			drop->count--;
+		}
+
+		memcpy(drop->cid[drop->count], storage->raw_cid, sizeof(drop->cid[0]));
+		drop->count++;
+	}
+
+	if (cache->magic != SDMMC_TUNING_CACHE_MAGIC || cache->count > SDMMC_TUNING_PROFILES)
+		return;
+
+	for (u32 i = 0; i < cache->count;)
+	{
+		if (!memcmp(cache->profiles[i].cid, storage->raw_cid, sizeof(storage->raw_cid)))
+		{
+			memmove(&cache->profiles[i], &cache->profiles[i + 1], sizeof(sdmmc_tuning_profile_t) * (cache->count - i - 1));
+			cache->count--;
+		}
+		else
+			i++;
+	}
+}
+
+static int _sdmmc_storage_tuning_execute(sdmmc_storage_t *storage, u32 type, u32 cmd)
+{
+	sdmmc_t *sdmmc = storage->sdmmc;
+
+	// Apply known good tap for this card and verify it with a data read.
+	sdmmc_tuning_profile_t *prof = _sdmmc_storage_tuning_find(storage->raw_cid, type);
+	if (prof && !sdmmc->powersave_enabled)
+	{
+		sdmmc_set_tap_value(sdmmc, prof->tap);
+
+		u8 *buf = (u8 *)SDMMC_UPPER_BUFFER;
+		int res = sdmmc->id == SDMMC_4 ? mmc_storage_get_ext_csd(storage, buf) : sd_storage_get_ssr(storage, buf);
+		if (res)
+		{
+			storage->tuning_cached = 1;
+			return 1;
+		}
+		DPRINTF("[SDMMC] cached tap %d failed\n", prof->tap);
+	}
+
+	TRACE_BEGIN("sdmmc_tuning");
+	int res = sdmmc_tuning_execute(sdmmc, type, cmd);
+	TRACE_END("sdmmc_tuning");
+	if (!res)
+		return 0;
+
+	sdmmc_tuning_profile_t new_prof;
+	memcpy(new_prof.cid, storage->raw_cid, sizeof(new_prof.cid));
+	new_prof.type = type;
+	new_prof.tap  = sdmmc_get_tap_value(sdmmc);
+	sdmmc_storage_tuning_cache_add(&new_prof, true);
+
 	return 1;
 }
 
@@ -243,93 +381,229 @@ int sdmmc_storage_end(sdmmc_storage_t *storage)
 	return 1;
 }
 
-static int _sdmmc_storage_readwrite(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf, u32 is_write)
+static int _sdmmc_storage_req_start(sdmmc_storage_t *storage, sdmmc_storage_req_t *req)
 {
-	u8 *bbuf = (u8 *)buf;
-	u32 sct_off = sector;
-	u32 sct_total = num_sectors;
-	bool first_reinit = true;
+	sdmmc_cmd_t cmdbuf;
+	sdmmc_req_t reqbuf;
+	u32 sector = req->sector + req->done;
 
-	// Exit if not initialized.
-	if (!storage->initialized)
-		return 0;
+	// If SDSC convert block address to byte address.
+	if (!storage->has_sector_access)
+		sector <<= 9;
+
+	reqbuf.buf              = (u8 *)req->buf + req->done * 512;
+	reqbuf.num_sectors      = MIN(req->num_sectors - req->done, storage->xfer_max_sct);
+	reqbuf.blksize          = 512;
+	reqbuf.is_write         = req->is_write;
+	reqbuf.is_multi_block   = 1;
+	reqbuf.is_auto_stop_trn = 1;
+
+	sdmmc_init_cmd(&cmdbuf, req->is_write ? MMC_WRITE_MULTIPLE_BLOCK : MMC_READ_MULTIPLE_BLOCK, sector, SDMMC_RSP_TYPE_1, 0);
+
+	return sdmmc_execute_cmd_async(storage->sdmmc, &cmdbuf, &reqbuf);
+}
 
-	while (sct_total)
+static void _sdmmc_storage_req_error(sdmmc_storage_t *storage, sdmmc_storage_req_t *req)
+{
+	u32 tmp = 0;
+
+	sdmmc_stop_transmission(storage->sdmmc, &tmp);
+	_sdmmc_storage_get_status(storage, &tmp, 0);
+
+	if (storage->sdmmc->id == SDMMC_4)
+		emmc_error_count_increment(EMMC_ERROR_RW_RETRY);
+	else
+		sd_error_count_increment(SD_ERROR_RW_RETRY);
+
+	// Shrink transfer length. Marginal cards often pass with shorter transfers.
+	storage->xfer_max_sct = MAX(storage->xfer_max_sct >> 2, SDMMC_XFER_MIN_SCT);
+	storage->xfer_ok_cnt  = 0;
+
+	// Retry 5 times if failed. Completed blocks are kept, so it resumes from the failed one.
+	req->retries--;
+	if (req->retries)
 	{
-		u32 blkcnt = 0;
-		// Retry 5 times if failed.
-		u32 retries = 5;
-		do
+		req->status = SDMMC_REQ_RETRY;
+		req->retry_time = get_tmr_ms() + (SDMMC_RETRY_DELAY << (4 - req->retries));
+
+		return;
+	}
+
+	// Disk IO failure! Cached tuning can't be trusted anymore.
+	_sdmmc_storage_tuning_drop(storage);
+
+	// Reinit SD/EMMC to a lower speed.
+	int res = 0;
+	sdmmc_storage_req_t *queue = storage->req_queue;
+	u32 xfer_max_sct = storage->xfer_max_sct;
+	if (storage->sdmmc->id == SDMMC_1)
+	{
+		sd_error_count_increment(SD_ERROR_RW_FAIL);
+
+		if (!req->reinit_done)
+			res = sd_initialize(true);
+		else
+		{
+			res = sd_init_retry(true);
+			if (!res)
+				sd_error_count_increment(SD_ERROR_INIT_FAIL);
+		}
+	}
+	else if (storage->sdmmc->id == SDMMC_4)
+	{
+		emmc_error_count_increment(EMMC_ERROR_RW_FAIL);
+
+		if (!req->reinit_done)
+			res = emmc_initialize(true);
+		else
 		{
-reinit_try:
-			if (_sdmmc_storage_readwrite_ex(storage, &blkcnt, sct_off, MIN(sct_total, 0xFFFF), bbuf, is_write))
-				goto out;
-			else
-				retries--;
+			res = emmc_init_retry(true);
+			if (!res)
+				emmc_error_count_increment(EMMC_ERROR_INIT_FAIL);
+		}
+	}
+	else
+	{
+		req->status = SDMMC_REQ_FAILED;
+
+		return;
+	}
+
+	// Reinit clears the storage context.
+	storage->req_queue    = queue;
+	storage->xfer_max_sct = xfer_max_sct;
+
+	// If successful reinit, resume xfer.
+	if (res)
+	{
+		req->retries = 3;
+		req->reinit_done = true;
+		req->status = SDMMC_REQ_RETRY;
+		req->retry_time = get_tmr_ms();
+	}
+	else
+		req->status = SDMMC_REQ_FAILED;
+}
 
-			sd_error_count_increment(SD_ERROR_RW_RETRY);
+int sdmmc_storage_submit(sdmmc_storage_t *storage, sdmmc_storage_req_t *req)
+{
+	// Exit if not initialized.
+	if (!storage->initialized || !req->num_sectors)
+		return 0;
+
+	if (!storage->xfer_max_sct)
+		storage->xfer_max_sct = SDMMC_XFER_MAX_SCT;
+
+	req->done        = 0;
+	req->retries     = 5;
+	req->reinit_done = false;
+	req->retry_time  = 0;
+	req->status      = SDMMC_REQ_QUEUED;
+	req->next        = NULL;
+
+	// Append to controller queue.
+	sdmmc_storage_req_t **tail = &storage->req_queue;
+	while (*tail)
+		tail = &(*tail)->next;
+	*tail = req;
 
-			msleep(50);
-		} while (retries);
+	return 1;
+}
+
+int sdmmc_storage_poll(sdmmc_storage_t *storage)
+{
+	sdmmc_storage_req_t *req = storage->req_queue;
+	if (!req)
+		return 0;
 
-		// Disk IO failure! Reinit SD/EMMC to a lower speed.
-		if (storage->sdmmc->id == SDMMC_1 || storage->sdmmc->id == SDMMC_4)
+	u32 blkcnt = 0;
+	switch (req->status)
+	{
+	case SDMMC_REQ_ACTIVE:
+		switch (sdmmc_poll_cmd_async(storage->sdmmc, &blkcnt))
 		{
-			int res;
+		case SDMMC_ASYNC_PENDING:
+			return 1;
+		case SDMMC_ASYNC_DONE:
+			req->done += blkcnt;
+			req->retries = 5;
 
-			if (storage->sdmmc->id == SDMMC_1)
+			// Grow transfer length back after enough successful transfers.
+			if (storage->xfer_max_sct < SDMMC_XFER_MAX_SCT && ++storage->xfer_ok_cnt >= SDMMC_XFER_GROW_CNT)
 			{
-				sd_error_count_increment(SD_ERROR_RW_FAIL);
-
-				if (first_reinit)
-					res = sd_initialize(true);
-				else
-				{
-					res = sd_init_retry(true);
-					if (!res)
-						sd_error_count_increment(SD_ERROR_INIT_FAIL);
-				}
-			}
-			else if (storage->sdmmc->id == SDMMC_4)
-			{
-				emmc_error_count_increment(EMMC_ERROR_RW_FAIL);
-
-				if (first_reinit)
-					res = emmc_initialize(true);
-				else
-				{
-					res = emmc_init_retry(true);
-					if (!res)
-						emmc_error_count_increment(EMMC_ERROR_INIT_FAIL);
-				}
+				storage->xfer_max_sct = MIN(storage->xfer_max_sct << 1, SDMMC_XFER_MAX_SCT);
+				storage->xfer_ok_cnt  = 0;
 			}
+			req->status = req->done < req->num_sectors ? SDMMC_REQ_QUEUED : SDMMC_REQ_DONE;
+			break;
+		default:
+			_sdmmc_storage_req_error(storage, req);
+			break;
+		}
+		break;
 
-			// Reset values for a retry.
-			blkcnt = 0;
-			retries = 3;
-			first_reinit = false;
+	case SDMMC_REQ_RETRY:
+		if (get_tmr_ms() < req->retry_time)
+			return 1;
+		// Fall through.
+	case SDMMC_REQ_QUEUED:
+		if (!storage->initialized)
+			req->status = SDMMC_REQ_FAILED;
+		else if (_sdmmc_storage_req_start(storage, req))
+			req->status = SDMMC_REQ_ACTIVE;
+		else
+			_sdmmc_storage_req_error(storage, req);
+		break;
+	}
 
-			// If successful reinit, restart xfer.
-			if (res)
-			{
-				bbuf = (u8 *)buf;
-				sct_off = sector;
-				sct_total = num_sectors;
+	// Complete and start next one on the following poll.
+	if (req->status == SDMMC_REQ_DONE || req->status == SDMMC_REQ_FAILED)
+	{
+		storage->req_queue = req->next;
+		if (req->complete)
+			req->complete(req);
+	}
 
-				goto reinit_try;
-			}
-		}
+	return storage->req_queue != NULL;
+}
 
-		// Failed.
+int sdmmc_storage_cancel(sdmmc_storage_t *storage, sdmmc_storage_req_t *req)
+{
+	// In-flight transfer can't be stopped.
+	if (req->status == SDMMC_REQ_ACTIVE)
 		return 0;
 
-out:
-		sct_off += blkcnt;
-		sct_total -= blkcnt;
-		bbuf += 512 * blkcnt;
+	for (sdmmc_storage_req_t **curr = &storage->req_queue; *curr; curr = &(*curr)->next)
+	{
+		if (*curr == req)
+		{
+			*curr = req->next;
+			req->status = SDMMC_REQ_FAILED;
+
+			return 1;
+		}
 	}
 
-	return 1;
+	return 0;
+}
+
+static int _sdmmc_storage_readwrite(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf, u32 is_write)
+{
+	sdmmc_storage_req_t req;
+
+	req.sector      = sector;
+	req.num_sectors = num_sectors;
+	req.buf         = buf;
+	req.is_write    = is_write;
+	req.complete    = NULL;
+
+	if (!sdmmc_storage_submit(storage, &req))
+		return 0;
+
+	while (req.status != SDMMC_REQ_DONE && req.status != SDMMC_REQ_FAILED)
+		sdmmc_storage_poll(storage);
+
+	return req.status == SDMMC_REQ_DONE;
 }
 
 int sdmmc_storage_read(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf)
@@ -394,34 +668,6 @@ static int _mmc_storage_get_op_cond_inner(sdmmc_storage_t *storage, u32 *pout, u
 	return sdmmc_get_rsp(storage->sdmmc, pout, 4, SDMMC_RSP_TYPE_3);
 }
 
-static int _mmc_storage_get_op_cond(sdmmc_storage_t *storage, u32 power)
-{
-	u32 timeout = get_tmr_ms() + 1500;
-
-	while (true)
-	{
-		u32 cond = 0;
-		if (!_mmc_storage_get_op_cond_inner(storage, &cond, power))
-			break;
-
-		// Check if power up is done.
-		if (cond & MMC_CARD_BUSY)
-		{
-			// Check if card is high capacity.
-			if (cond & MMC_CARD_CCS)
-				storage->has_sector_access = 1;
-
-			return 1;
-		}
-		if (get_tmr_ms() > timeout)
-			break;
-
-		usleep(1000);
-	}
-
-	return 0;
-}
-
 static int _mmc_storage_set_relative_addr(sdmmc_storage_t *storage)
 {
 	return _sdmmc_storage_execute_cmd_type1(storage, MMC_SET_RELATIVE_ADDR, storage->rca << 16, 0, R1_SKIP_STATE_CHECK);
@@ -596,7 +842,7 @@ static int _mmc_storage_enable_HS200(sdmmc_storage_t *storage)
 	if (!sdmmc_setup_clock(storage->sdmmc, SDHCI_TIMING_MMC_HS200))
 		return 0;
 
-	if (!sdmmc_tuning_execute(storage->sdmmc, SDHCI_TIMING_MMC_HS200, MMC_SEND_TUNING_BLOCK_HS200))
+	if (!_sdmmc_storage_tuning_execute(storage, SDHCI_TIMING_MMC_HS200, MMC_SEND_TUNING_BLOCK_HS200))
 		return 0;
 
 	DPRINTF("[MMC] switched to HS200\n");
@@ -664,29 +910,8 @@ static int _mmc_storage_enable_auto_bkops(sdmmc_storage_t *storage)
 }
 */
 
-int sdmmc_storage_init_mmc(sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type)
+static int _mmc_storage_init_finish(sdmmc_storage_t *storage, u32 bus_width, u32 type)
 {
-	memset(storage, 0, sizeof(sdmmc_storage_t));
-	storage->sdmmc = sdmmc;
-	storage->rca = 2; // Set default device address. This could be a config item.
-
-	DPRINTF("[MMC]-[init: bus: %d, type: %d]\n", bus_width, type);
-
-	if (!sdmmc_init(sdmmc, SDMMC_4, SDMMC_POWER_1_8, SDMMC_BUS_WIDTH_1, SDHCI_TIMING_MMC_ID))
-		return 0;
-	DPRINTF("[MMC] after init\n");
-
-	// Wait 1ms + 74 cycles.
-	usleep(1000 + (74 * 1000 + sdmmc->card_clock - 1) / sdmmc->card_clock);
-
-	if (!_sdmmc_storage_go_idle_state(storage))
-		return 0;
-	DPRINTF("[MMC] went to idle state\n");
-
-	if (!_mmc_storage_get_op_cond(storage, SDMMC_POWER_1_8))
-		return 0;
-	DPRINTF("[MMC] got op cond\n");
-
 	if (!_sdmmc_storage_get_cid(storage))
 		return 0;
 	DPRINTF("[MMC] got cid\n");
@@ -746,6 +971,88 @@ done:
 	return 1;
 }
 
+static int _mmc_storage_init_step(sdmmc_storage_init_t *init)
+{
+	u32 cond = 0;
+	sdmmc_storage_t *storage = init->storage;
+	sdmmc_t *sdmmc = init->sdmmc;
+
+	switch (init->step)
+	{
+	case SDMMC_INIT_STEP_POWER:
+		memset(storage, 0, sizeof(sdmmc_storage_t));
+		storage->sdmmc = sdmmc;
+		storage->rca = 2; // Set default device address. This could be a config item.
+
+		DPRINTF("[MMC]-[init: bus: %d, type: %d]\n", init->bus_width, init->type);
+
+		if (!sdmmc_init(sdmmc, SDMMC_4, SDMMC_POWER_1_8, SDMMC_BUS_WIDTH_1, SDHCI_TIMING_MMC_ID))
+			return SDMMC_INIT_FAILED;
+		DPRINTF("[MMC] after init\n");
+
+		// Wait 1ms + 74 cycles.
+		init->next = get_tmr_us() + 1000 + (74 * 1000 + sdmmc->card_clock - 1) / sdmmc->card_clock;
+		init->step = SDMMC_INIT_STEP_IDLE;
+		return SDMMC_INIT_PENDING;
+
+	case SDMMC_INIT_STEP_IDLE:
+		if (!_sdmmc_storage_go_idle_state(storage))
+			return SDMMC_INIT_FAILED;
+		DPRINTF("[MMC] went to idle state\n");
+
+		init->timeout = get_tmr_ms() + 1500;
+		init->step = SDMMC_INIT_STEP_OP_COND;
+		// Fall through.
+
+	case SDMMC_INIT_STEP_OP_COND:
+		if (!_mmc_storage_get_op_cond_inner(storage, &cond, SDMMC_POWER_1_8))
+			return SDMMC_INIT_FAILED;
+
+		// Check if power up is done.
+		if (!(cond & MMC_CARD_BUSY))
+		{
+			if (get_tmr_ms() > init->timeout)
+				return SDMMC_INIT_FAILED;
+
+			init->next = get_tmr_us() + 1000;
+			return SDMMC_INIT_PENDING;
+		}
+
+		// Check if card is high capacity.
+		if (cond & MMC_CARD_CCS)
+			storage->has_sector_access = 1;
+		DPRINTF("[MMC] got op cond\n");
+
+		init->step = SDMMC_INIT_STEP_FINISH;
+		return SDMMC_INIT_PENDING;
+
+	case SDMMC_INIT_STEP_FINISH:
+		return _mmc_storage_init_finish(storage, init->bus_width, init->type) ? SDMMC_INIT_DONE : SDMMC_INIT_FAILED;
+	}
+
+	return SDMMC_INIT_FAILED;
+}
+
+int sdmmc_storage_init_mmc_start(sdmmc_storage_init_t *init, sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type)
+{
+	memset(init, 0, sizeof(sdmmc_storage_init_t));
+	init->storage   = storage;
+	init->sdmmc     = sdmmc;
+	init->bus_width = bus_width;
+	init->type      = type;
+	init->status    = SDMMC_INIT_PENDING;
+
+	return sdmmc_storage_init_step(init);
+}
+
+int sdmmc_storage_init_mmc(sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type)
+{
+	sdmmc_storage_init_t init;
+	sdmmc_storage_init_mmc_start(&init, storage, sdmmc, bus_width, type);
+
+	return sdmmc_storage_init_run(&init);
+}
+
 int sdmmc_storage_set_mmc_partition(sdmmc_storage_t *storage, u32 partition)
 {
 	if (!_mmc_storage_switch(storage, SDMMC_SWITCH(MMC_SWITCH_MODE_WRITE_BYTE, EXT_CSD_PART_CONFIG, partition)))
@@ -949,55 +1256,37 @@ static int _sd_storage_get_op_cond_once(sdmmc_storage_t *storage, u32 *cond, boo
 	return sdmmc_get_rsp(storage->sdmmc, cond, 4, SDMMC_RSP_TYPE_3);
 }
 
-static int _sd_storage_get_op_cond(sdmmc_storage_t *storage, bool is_sdsc, int bus_uhs_support)
+static int _sd_storage_op_cond_done(sdmmc_storage_t *storage, u32 cond, int bus_uhs_support)
 {
-	u32 timeout = get_tmr_ms() + 1500;
+	DPRINTF("[SD] op cond: %08X, lv: %d\n", cond, bus_uhs_support);
 
-	while (true)
-	{
-		u32 cond = 0;
-		if (!_sd_storage_get_op_cond_once(storage, &cond, is_sdsc, bus_uhs_support))
-			break;
+	// Check if card is high capacity.
+	if (cond & SD_OCR_CCS)
+		storage->has_sector_access = 1;
 
-		// Check if power up is done.
-		if (cond & SD_OCR_BUSY)
+	// Check if card supports 1.8V signaling.
+	if (cond & SD_ROCR_S18A && bus_uhs_support)
+	{
+		// Switch to 1.8V signaling.
+		if (_sdmmc_storage_execute_cmd_type1(storage, SD_SWITCH_VOLTAGE, 0, 0, R1_STATE_READY))
 		{
-			DPRINTF("[SD] op cond: %08X, lv: %d\n", cond, bus_uhs_support);
-
-			// Check if card is high capacity.
-			if (cond & SD_OCR_CCS)
-				storage->has_sector_access = 1;
-
-			// Check if card supports 1.8V signaling.
-			if (cond & SD_ROCR_S18A && bus_uhs_support)
-			{
-				// Switch to 1.8V signaling.
-				if (_sdmmc_storage_execute_cmd_type1(storage, SD_SWITCH_VOLTAGE, 0, 0, R1_STATE_READY))
-				{
-					if (!sdmmc_setup_clock(storage->sdmmc, SDHCI_TIMING_UHS_SDR12))
-						return 0;
-
-					if (!sdmmc_enable_low_voltage(storage->sdmmc))
-						return 0;
+			if (!sdmmc_setup_clock(storage->sdmmc, SDHCI_TIMING_UHS_SDR12))
+				return 0;
 
-					storage->is_low_voltage = 1;
+			if (!sdmmc_enable_low_voltage(storage->sdmmc))
+				return 0;
 
-					DPRINTF("-> switched to low voltage\n");
-				}
-			}
-			else
-			{
-				DPRINTF("[SD] no low voltage support\n");
-			}
+			storage->is_low_voltage = 1;
 
-			return 1;
+			DPRINTF("-> switched to low voltage\n");
 		}
-		if (get_tmr_ms() > timeout)
-			break;
-		msleep(10); // Needs to be at least 10ms for some SD Cards
+	}
+	else
+	{
+		DPRINTF("[SD] no low voltage support\n");
 	}
 
-	return 0;
+	return 1;
 }
 
 static int _sd_storage_get_rca(sdmmc_storage_t *storage)
@@ -1251,7 +1540,7 @@ static int _sd_storage_enable_DDR200(sdmmc_storage_t *storage, u8 *buf)
 			return 0;
 		DPRINTF("[SD] after setup clock DDR200\n");
 
-		if (!sdmmc_tuning_execute(storage->sdmmc, SDHCI_TIMING_UHS_DDR200, MMC_SEND_TUNING_BLOCK))
+		if (!_sdmmc_storage_tuning_execute(storage, SDHCI_TIMING_UHS_DDR200, MMC_SEND_TUNING_BLOCK))
 			return 0;
 		DPRINTF("[SD] after tuning DDR200\n");
 
@@ -1393,7 +1682,7 @@ static int _sd_storage_enable_uhs_low_volt(sdmmc_storage_t *storage, u32 type, u
 		return 0;
 	DPRINTF("[SD] after setup clock\n");
 
-	if (!sdmmc_tuning_execute(storage->sdmmc, type, MMC_SEND_TUNING_BLOCK))
+	if (!_sdmmc_storage_tuning_execute(storage, type, MMC_SEND_TUNING_BLOCK))
 		return 0;
 	DPRINTF("[SD] after tuning\n");
 
@@ -1624,39 +1913,10 @@ void sdmmc_storage_init_wait_sd()
 		msleep(239 - sd_poweroff_time);
 }
 
-int sdmmc_storage_init_sd(sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type)
+static int _sd_storage_init_finish(sdmmc_storage_t *storage, u32 bus_width, u32 type)
 {
 	u32  tmp = 0;
-	int  is_sdsc = 0;
 	u8  *buf = (u8 *)SDMMC_UPPER_BUFFER;
-	bool bus_uhs_support = _sdmmc_storage_get_bus_uhs_support(bus_width, type);
-
-	DPRINTF("[SD]-[init: bus: %d, type: %d]\n", bus_width, type);
-
-	// Some cards (SanDisk U1), do not like a fast power cycle. Wait min 100ms.
-	sdmmc_storage_init_wait_sd();
-
-	memset(storage, 0, sizeof(sdmmc_storage_t));
-	storage->sdmmc = sdmmc;
-
-	if (!sdmmc_init(sdmmc, SDMMC_1, SDMMC_POWER_3_3, SDMMC_BUS_WIDTH_1, SDHCI_TIMING_SD_ID))
-		return 0;
-	DPRINTF("[SD] after init\n");
-
-	// Wait 1ms + 74 cycles.
-	usleep(1000 + (74 * 1000 + sdmmc->card_clock - 1) / sdmmc->card_clock);
-
-	if (!_sdmmc_storage_go_idle_state(storage))
-		return 0;
-	DPRINTF("[SD] went to idle state\n");
-
-	if (!_sd_storage_send_if_cond(storage, &is_sdsc))
-		return 0;
-	DPRINTF("[SD] after send if cond\n");
-
-	if (!_sd_storage_get_op_cond(storage, is_sdsc, bus_uhs_support))
-		return 0;
-	DPRINTF("[SD] got op cond\n");
 
 	if (!_sdmmc_storage_get_cid(storage))
 		return 0;
@@ -1741,13 +2001,158 @@ int sdmmc_storage_init_sd(sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_widt
 		DPRINTF("[SD] got sd status\n");
 	}
 
-	sdmmc_card_clock_powersave(sdmmc, SDMMC_POWER_SAVE_ENABLE);
+	sdmmc_card_clock_powersave(storage->sdmmc, SDMMC_POWER_SAVE_ENABLE);
 
 	storage->initialized = 1;
 
 	return 1;
 }
 
+static int _sd_storage_init_step(sdmmc_storage_init_t *init)
+{
+	u32 cond = 0;
+	u32 sd_poweroff_time;
+	sdmmc_storage_t *storage = init->storage;
+	sdmmc_t *sdmmc = init->sdmmc;
+
+	switch (init->step)
+	{
+	case SDMMC_INIT_STEP_POWER:
+		// Some cards (SanDisk U1), do not like a fast power cycle. Wait min 100ms.
+		// T210/T210B01 WAR: Wait exactly 239ms for IO and Controller power to discharge.
+		sd_poweroff_time = (u32)get_tmr_ms() - sd_power_cycle_time_start;
+		if (sd_poweroff_time < 239)
+		{
+			init->next = get_tmr_us() + (239 - sd_poweroff_time) * 1000;
+			return SDMMC_INIT_PENDING;
+		}
+
+		memset(storage, 0, sizeof(sdmmc_storage_t));
+		storage->sdmmc = sdmmc;
+
+		if (!sdmmc_init(sdmmc, SDMMC_1, SDMMC_POWER_3_3, SDMMC_BUS_WIDTH_1, SDHCI_TIMING_SD_ID))
+			return SDMMC_INIT_FAILED;
+		DPRINTF("[SD] after init\n");
+
+		// Wait 1ms + 74 cycles.
+		init->next = get_tmr_us() + 1000 + (74 * 1000 + sdmmc->card_clock - 1) / sdmmc->card_clock;
+		init->step = SDMMC_INIT_STEP_IDLE;
+		return SDMMC_INIT_PENDING;
+
+	case SDMMC_INIT_STEP_IDLE:
+		if (!_sdmmc_storage_go_idle_state(storage))
+			return SDMMC_INIT_FAILED;
+		DPRINTF("[SD] went to idle state\n");
+
+		if (!_sd_storage_send_if_cond(storage, &init->is_sdsc))
+			return SDMMC_INIT_FAILED;
+		DPRINTF("[SD] after send if cond\n");
+
+		init->timeout = get_tmr_ms() + 1500;
+		init->step = SDMMC_INIT_STEP_OP_COND;
+		// Fall through.
+
+	case SDMMC_INIT_STEP_OP_COND:
+		if (!_sd_storage_get_op_cond_once(storage, &cond, init->is_sdsc, init->bus_uhs_support))
+			return SDMMC_INIT_FAILED;
+
+		// Check if power up is done.
+		if (!(cond & SD_OCR_BUSY))
+		{
+			if (get_tmr_ms() > init->timeout)
+				return SDMMC_INIT_FAILED;
+
+			init->next = get_tmr_us() + 10000; // Needs to be at least 10ms for some SD Cards
+			return SDMMC_INIT_PENDING;
+		}
+
+		if (!_sd_storage_op_cond_done(storage, cond, init->bus_uhs_support))
+			return SDMMC_INIT_FAILED;
+		DPRINTF("[SD] got op cond\n");
+
+		init->step = SDMMC_INIT_STEP_FINISH;
+		return SDMMC_INIT_PENDING;
+
+	case SDMMC_INIT_STEP_FINISH:
+		return _sd_storage_init_finish(storage, init->bus_width, init->type) ? SDMMC_INIT_DONE : SDMMC_INIT_FAILED;
+	}
+
+	return SDMMC_INIT_FAILED;
+}
+
+static sdmmc_storage_init_t *sdmmc_init_bg = NULL;
+
+void sdmmc_storage_init_set_background(sdmmc_storage_init_t *init)
+{
+	sdmmc_init_bg = init;
+}
+
+int sdmmc_storage_init_step(sdmmc_storage_init_t *init)
+{
+	if (init->status != SDMMC_INIT_PENDING)
+		return init->status;
+
+	// Not yet time for the next step.
+	if ((s32)(init->next - get_tmr_us()) > 0)
+		return SDMMC_INIT_PENDING;
+
+	if (init->is_sd)
+		init->status = _sd_storage_init_step(init);
+	else
+		init->status = _mmc_storage_init_step(init);
+
+	if (init == sdmmc_init_bg && init->status != SDMMC_INIT_PENDING)
+		sdmmc_init_bg = NULL;
+
+	return init->status;
+}
+
+int sdmmc_storage_init_run(sdmmc_storage_init_t *init)
+{
+	if (init == sdmmc_init_bg)
+		sdmmc_init_bg = NULL;
+
+	while (sdmmc_storage_init_step(init) == SDMMC_INIT_PENDING)
+	{
+		// Advance the background init while waiting for the card.
+		if (sdmmc_init_bg)
+		{
+			sdmmc_storage_init_step(sdmmc_init_bg);
+			continue;
+		}
+
+		s32 wait = init->next - get_tmr_us();
+		if (wait > 0)
+			usleep(wait);
+	}
+
+	return init->status == SDMMC_INIT_DONE;
+}
+
+int sdmmc_storage_init_sd_start(sdmmc_storage_init_t *init, sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type)
+{
+	memset(init, 0, sizeof(sdmmc_storage_init_t));
+	init->storage         = storage;
+	init->sdmmc           = sdmmc;
+	init->bus_width       = bus_width;
+	init->type            = type;
+	init->bus_uhs_support = _sdmmc_storage_get_bus_uhs_support(bus_width, type);
+	init->is_sd           = true;
+	init->status          = SDMMC_INIT_PENDING;
+
+	DPRINTF("[SD]-[init: bus: %d, type: %d]\n", bus_width, type);
+
+	return sdmmc_storage_init_step(init);
+}
+
+int sdmmc_storage_init_sd(sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type)
+{
+	sdmmc_storage_init_t init;
+	sdmmc_storage_init_sd_start(&init, storage, sdmmc, bus_width, type);
+
+	return sdmmc_storage_init_run(&init);
+}
+
 /*
  * Gamecard specific functions.
  */
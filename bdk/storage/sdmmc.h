@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2018 naehrwert
- * Copyright (c) 2018-2022 CTCaer
+ * Copyright (c) 2018-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -173,6 +173,56 @@ typedef struct _sd_ssr
 	u32 protected_size;
 } sd_ssr_t;
 
+/*! SDMMC storage async request status. */
+#define SDMMC_REQ_QUEUED 0
+#define SDMMC_REQ_ACTIVE 1
+#define SDMMC_REQ_RETRY  2
+#define SDMMC_REQ_DONE   3
+#define SDMMC_REQ_FAILED 4
+
+typedef struct _sdmmc_storage_req_t
+{
+	u32 sector;
+	u32 num_sectors;
+	void *buf;
+	u32 is_write;
+	void (*complete)(struct _sdmmc_storage_req_t *req); // Optional. Called from sdmmc_storage_poll.
+	void *priv;
+	// Internal.
+	int status;
+	u32 done;
+	u32 retries;
+	bool reinit_done;
+	u32 retry_time;
+	struct _sdmmc_storage_req_t *next;
+} sdmmc_storage_req_t;
+
+/*! SDMMC per card tuning profiles. Kept in nyx_str across hekate and Nyx. */
+#define SDMMC_TUNING_CACHE_MAGIC 0x4E555453 // "STUN".
+#define SDMMC_TUNING_PROFILES    8
+
+typedef struct _sdmmc_tuning_profile_t
+{
+	u8  cid[0x10];
+	u32 type; // SDHCI_TIMING_*.
+	u32 tap;
+} sdmmc_tuning_profile_t;
+
+typedef struct _sdmmc_tuning_cache_t
+{
+	u32 magic;
+	u32 count;
+	sdmmc_tuning_profile_t profiles[SDMMC_TUNING_PROFILES];
+} sdmmc_tuning_cache_t;
+
+/*! Cards whose profiles were dropped after I/O failures. Pending removal from the saved cache. */
+typedef struct _sdmmc_tuning_drop_t
+{
+	u32 magic;
+	u32 count;
+	u8  cid[SDMMC_TUNING_PROFILES][0x10];
+} sdmmc_tuning_drop_t;
+
 /*! SDMMC storage context. */
 typedef struct _sdmmc_storage_t
 {
@@ -193,16 +243,62 @@ typedef struct _sdmmc_storage_t
 	mmc_ext_csd_t ext_csd;
 	sd_scr_t      scr;
 	sd_ssr_t      ssr;
+	sdmmc_storage_req_t *req_queue;
+	u32 xfer_max_sct; // Adaptive max sectors per transfer.
+	u32 xfer_ok_cnt;
+	int tuning_cached;
 } sdmmc_storage_t;
 
+/*! SDMMC resumable init. Card waits are returned to the caller instead of slept. */
+#define SDMMC_INIT_DONE    1
+#define SDMMC_INIT_PENDING 0
+#define SDMMC_INIT_FAILED  -1
+
+enum
+{
+	SDMMC_INIT_STEP_POWER   = 0,
+	SDMMC_INIT_STEP_IDLE    = 1,
+	SDMMC_INIT_STEP_OP_COND = 2,
+	SDMMC_INIT_STEP_FINISH  = 3
+};
+
+typedef struct _sdmmc_storage_init_t
+{
+	sdmmc_storage_t *storage;
+	sdmmc_t *sdmmc;
+	u32  bus_width;
+	u32  type;
+	u32  step;
+	u32  next;    // Timestamp in us of the next step.
+	u32  timeout; // Op cond timeout in ms.
+	int  status;
+	bool is_sdsc;
+	bool is_sd;
+	int  bus_uhs_support;
+} sdmmc_storage_init_t;
+
 int  sdmmc_storage_end(sdmmc_storage_t *storage);
 int  sdmmc_storage_read(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf);
 int  sdmmc_storage_write(sdmmc_storage_t *storage, u32 sector, u32 num_sectors, void *buf);
+int  sdmmc_storage_submit(sdmmc_storage_t *storage, sdmmc_storage_req_t *req);
+int  sdmmc_storage_poll(sdmmc_storage_t *storage);
+int  sdmmc_storage_cancel(sdmmc_storage_t *storage, sdmmc_storage_req_t *req);
 int  sdmmc_storage_init_mmc(sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type);
 int  sdmmc_storage_set_mmc_partition(sdmmc_storage_t *storage, u32 partition);
 void sdmmc_storage_init_wait_sd();
 int  sdmmc_storage_init_sd(sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type);
 int  sdmmc_storage_init_gc(sdmmc_storage_t *storage, sdmmc_t *sdmmc);
+int  sdmmc_storage_init_mmc_start(sdmmc_storage_init_t *init, sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type);
+int  sdmmc_storage_init_sd_start(sdmmc_storage_init_t *init, sdmmc_storage_t *storage, sdmmc_t *sdmmc, u32 bus_width, u32 type);
+int  sdmmc_storage_init_step(sdmmc_storage_init_t *init);
+int  sdmmc_storage_init_run(sdmmc_storage_init_t *init);
+void sdmmc_storage_init_set_background(sdmmc_storage_init_t *init);
+
+void sdmmc_storage_tuning_cache_reset();
+int  sdmmc_storage_tuning_cache_add(const sdmmc_tuning_profile_t *prof, bool replace);
+u32  sdmmc_storage_tuning_drop_count();
+bool sdmmc_storage_tuning_dropped(const u8 *cid);
+void sdmmc_storage_tuning_drop_reset();
 
 int  sdmmc_storage_execute_vendor_cmd(sdmmc_storage_t *storage, u32 arg);
 int  sdmmc_storage_vendor_sandisk_report(sdmmc_storage_t *storage, void *buf);
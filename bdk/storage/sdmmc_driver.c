@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2018 naehrwert
- * Copyright (c) 2018-2023 CTCaer
+ * Copyright (c) 2018-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -17,6 +17,7 @@
 
 #include <string.h>
 
+#include <memory_map.h>
 #include <storage/mmc.h>
 #include <storage/sdmmc.h>
 #include <gfx_utils.h>
@@ -112,6 +113,23 @@ void sdmmc_save_tap_value(sdmmc_t *sdmmc)
 	sdmmc->venclkctl_set = 1;
 }
 
+u32 sdmmc_get_tap_value(sdmmc_t *sdmmc)
+{
+	return (sdmmc->regs->venclkctl & 0xFF0000) >> 16;
+}
+
+void sdmmc_set_tap_value(sdmmc_t *sdmmc, u32 tap)
+{
+	sdmmc->regs->clkcon     &= ~SDHCI_CLOCK_CARD_EN;
+	sdmmc->regs->ventunctl0 &= ~SDHCI_TEGRA_TUNING_TAP_HW_UPDATED;
+
+	// Set tap.
+	sdmmc->regs->venclkctl   = (sdmmc->regs->venclkctl & 0xFF00FFFF) | (tap << 16);
+
+	sdmmc->regs->ventunctl0 |=  SDHCI_TEGRA_TUNING_TAP_HW_UPDATED;
+	sdmmc->regs->clkcon     |= SDHCI_CLOCK_CARD_EN;
+}
+
 static int _sdmmc_config_tap_val(sdmmc_t *sdmmc, u32 type)
 {
 	const u32 dqs_trim_val = 40; // 24 if HS533/HS667.
@@ -729,14 +747,7 @@ static int _sdmmc_manual_tuning_set_tap(sdmmc_t *sdmmc, sdmmc_manual_tuning_t *t
 	if (!best_tap || best_size < SAMPLING_WINDOW_SIZE_MIN)
 		return 0;
 
-	sdmmc->regs->clkcon     &= ~SDHCI_CLOCK_CARD_EN;
-	sdmmc->regs->ventunctl0 &= ~SDHCI_TEGRA_TUNING_TAP_HW_UPDATED;
-
-	// Set tap.
-	sdmmc->regs->venclkctl   = (sdmmc->regs->venclkctl & 0xFF00FFFF) | (best_tap << 16);
-
-	sdmmc->regs->ventunctl0 |=  SDHCI_TEGRA_TUNING_TAP_HW_UPDATED;
-	sdmmc->regs->clkcon     |= SDHCI_CLOCK_CARD_EN;
+	sdmmc_set_tap_value(sdmmc, best_tap);
 
 	return 1;
 }
@@ -862,6 +873,10 @@ static int _sdmmc_enable_internal_clock(sdmmc_t *sdmmc)
 	sdmmc->regs->hostctl   &= ~SDHCI_CTRL_DMA_MASK; // Use SDMA. Host V4 enabled so adma address regs in use.
 	sdmmc->regs->timeoutcon = (sdmmc->regs->timeoutcon & 0xF0) | 14; // TMCLK * 2^27.
 
+	// Use ADMA2 if supported. Each controller gets its own descriptor table.
+	if (sdmmc->regs->capareg & SDHCI_CAP_ADMA2)
+		sdmmc->adma_desc = (sdmmc_adma2_desc_t *)(SDMMC_ADMA_ADDR + sdmmc->id * (SDMMC_ADMA_SZ / 4));
+
 	return 1;
 }
 
@@ -914,14 +929,14 @@ static int _sdmmc_autocal_config_offset(sdmmc_t *sdmmc, u32 power)
 static void _sdmmc_enable_interrupts(sdmmc_t *sdmmc)
 {
 	sdmmc->regs->norintstsen |= SDHCI_INT_DMA_END | SDHCI_INT_DATA_END | SDHCI_INT_RESPONSE;
-	sdmmc->regs->errintstsen |= SDHCI_ERR_INT_ALL_EXCEPT_ADMA_BUSPWR;
+	sdmmc->regs->errintstsen |= SDHCI_ERR_INT_ALL_EXCEPT_ADMA_BUSPWR | (sdmmc->adma_desc ? SDHCI_ERR_INT_ADMA : 0);
 	sdmmc->regs->norintsts = sdmmc->regs->norintsts;
 	sdmmc->regs->errintsts = sdmmc->regs->errintsts;
 }
 
 static void _sdmmc_mask_interrupts(sdmmc_t *sdmmc)
 {
-	sdmmc->regs->errintstsen &= ~SDHCI_ERR_INT_ALL_EXCEPT_ADMA_BUSPWR;
+	sdmmc->regs->errintstsen &= ~(SDHCI_ERR_INT_ALL_EXCEPT_ADMA_BUSPWR | SDHCI_ERR_INT_ADMA);
 	sdmmc->regs->norintstsen &= ~(SDHCI_INT_DMA_END | SDHCI_INT_DATA_END | SDHCI_INT_RESPONSE);
 }
 
@@ -1027,7 +1042,46 @@ int sdmmc_stop_transmission(sdmmc_t *sdmmc, u32 *rsp)
 	return result;
 }
 
-static int _sdmmc_config_sdma(sdmmc_t *sdmmc, u32 *blkcnt_out, sdmmc_req_t *req)
+static int _sdmmc_config_adma(sdmmc_t *sdmmc, u32 blkcnt, sdmmc_req_t *req)
+{
+	sdmmc_adma2_desc_t *desc = sdmmc->adma_desc;
+	u32 addr = (u32)req->buf;
+	u32 size = blkcnt * req->blksize;
+	u32 mapped = 0;
+	u32 idx = 0;
+
+	// Check alignment.
+	if (addr & 7)
+		return 0;
+
+	while (mapped < size && idx < SDMMC_ADMA2_DESC_NUM)
+	{
+		u32 desc_len = MIN(size - mapped, SDMMC_ADMA2_MAX_LEN);
+
+		desc[idx].attr    = SDMMC_ADMA2_ACT_TRAN | SDMMC_ADMA2_VALID;
+		desc[idx].len     = desc_len;
+		desc[idx].addr    = addr + mapped;
+		desc[idx].addr_hi = 0;
+		desc[idx].rsvd    = 0;
+
+		idx++;
+		mapped += desc_len;
+	}
+
+	// Max block count always fits in the table.
+	if (mapped < size)
+		return 0;
+
+	desc[idx - 1].attr |= SDMMC_ADMA2_END;
+
+	sdmmc->regs->admaaddr    = (u32)desc;
+	sdmmc->regs->admaaddr_hi = 0;
+	sdmmc->regs->hostctl     = (sdmmc->regs->hostctl & ~SDHCI_CTRL_DMA_MASK) | SDHCI_CTRL_ADMA32; // ADMA2 in Host V4.
+
+	return 1;
+}
+
+static int _sdmmc_config_dma(sdmmc_t *sdmmc, u32 *blkcnt_out, sdmmc_req_t *req)
 {
 	if (!req->blksize || !req->num_sectors)
 		return 0;
@@ -1035,16 +1089,27 @@ static int _sdmmc_config_sdma(sdmmc_t *sdmmc, u32 *blkcnt_out, sdmmc_req_t *req)
 	u32 blkcnt = req->num_sectors;
 	if (blkcnt >= 0xFFFF)
 		blkcnt = 0xFFFF;
-	u32 admaaddr = (u32)req->buf;
 
-	// Check alignment.
-	if (admaaddr & 7)
-		return 0;
+	if (sdmmc->adma_desc)
+	{
+		// Whole transfer is described by the table. No CPU intervention on boundaries.
+		if (!_sdmmc_config_adma(sdmmc, blkcnt, req))
+			return 0;
+	}
+	else
+	{
+		u32 admaaddr = (u32)req->buf;
 
-	sdmmc->regs->admaaddr = admaaddr;
-	sdmmc->regs->admaaddr_hi = 0;
+		// Check alignment.
+		if (admaaddr & 7)
+			return 0;
+
+		sdmmc->regs->admaaddr = admaaddr;
+		sdmmc->regs->admaaddr_hi = 0;
+		sdmmc->regs->hostctl &= ~SDHCI_CTRL_DMA_MASK;
 
-	sdmmc->dma_addr_next = ALIGN_DOWN((admaaddr + SZ_512K), SZ_512K);
+		sdmmc->dma_addr_next = ALIGN_DOWN((admaaddr + SZ_512K), SZ_512K);
+	}
 
 	sdmmc->regs->blksize = req->blksize | (7u << 12); // SDMA DMA 512KB Boundary (Detects A18 carry out).
 	sdmmc->regs->blkcnt  = blkcnt;
@@ -1073,64 +1138,76 @@ static int _sdmmc_config_sdma(sdmmc_t *sdmmc, u32 *blkcnt_out, sdmmc_req_t *req)
 	return 1;
 }
 
-static int _sdmmc_update_sdma(sdmmc_t *sdmmc)
+static int _sdmmc_update_dma_step(sdmmc_t *sdmmc)
 {
-	u16 blkcnt = 0;
-	do
+	while (true)
 	{
-		blkcnt = sdmmc->regs->blkcnt;
-		u32 timeout = get_tmr_ms() + 1500;
-		do
+		u16 intr = 0;
+		u32 result = _sdmmc_check_mask_interrupt(sdmmc, &intr, SDHCI_INT_DATA_END | SDHCI_INT_DMA_END);
+		if (result == SDMMC_MASKINT_NOERROR)
+			break;
+
+		if (result != SDMMC_MASKINT_MASKED)
 		{
-			u32 result = SDMMC_MASKINT_MASKED;
-			while (true)
-			{
-				u16 intr = 0;
-				result = _sdmmc_check_mask_interrupt(sdmmc, &intr,
-					SDHCI_INT_DATA_END | SDHCI_INT_DMA_END);
-				if (result != SDMMC_MASKINT_MASKED)
-					break;
+#ifdef ERROR_EXTRA_PRINTING
+			EPRINTFARGS("SDMMC%d: int error!", sdmmc->id + 1);
+#endif
+			_sdmmc_reset_cmd_data(sdmmc);
 
-				if (intr & SDHCI_INT_DATA_END)
-					return 1; // Transfer complete.
+			return SDMMC_ASYNC_ERROR;
+		}
 
-				if (intr & SDHCI_INT_DMA_END)
-				{
-					// Update DMA.
-					sdmmc->regs->admaaddr = sdmmc->dma_addr_next;
-					sdmmc->regs->admaaddr_hi = 0;
-					sdmmc->dma_addr_next += SZ_512K;
-				}
-			}
+		if (intr & SDHCI_INT_DATA_END)
+			return SDMMC_ASYNC_DONE; // Transfer complete.
 
-			if (result != SDMMC_MASKINT_NOERROR)
-			{
-#ifdef ERROR_EXTRA_PRINTING
-				EPRINTFARGS("SDMMC%d: int error!", sdmmc->id + 1);
-#endif
-				_sdmmc_reset_cmd_data(sdmmc);
+		// Only SDMA raises it, on every 512KB boundary.
+		if (intr & SDHCI_INT_DMA_END)
+		{
+			// Update DMA.
+			sdmmc->regs->admaaddr = sdmmc->dma_addr_next;
+			sdmmc->regs->admaaddr_hi = 0;
+			sdmmc->dma_addr_next += SZ_512K;
+		}
+	}
 
-				return 0;
-			}
-		} while (get_tmr_ms() < timeout);
-	} while (sdmmc->regs->blkcnt != blkcnt);
+	// Time out only if no block was transferred for a while.
+	if (get_tmr_ms() > sdmmc->dma_timeout)
+	{
+		if (sdmmc->regs->blkcnt == sdmmc->dma_blkcnt)
+		{
+			_sdmmc_reset_cmd_data(sdmmc);
 
-	_sdmmc_reset_cmd_data(sdmmc);
+			return SDMMC_ASYNC_ERROR;
+		}
 
-	return 0;
+		sdmmc->dma_blkcnt  = sdmmc->regs->blkcnt;
+		sdmmc->dma_timeout = get_tmr_ms() + 1500;
+	}
+
+	return SDMMC_ASYNC_PENDING;
 }
 
-static int _sdmmc_execute_cmd_inner(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *blkcnt_out)
+static int _sdmmc_update_dma(sdmmc_t *sdmmc)
+{
+	int result;
+	do
+	{
+		result = _sdmmc_update_dma_step(sdmmc);
+	} while (result == SDMMC_ASYNC_PENDING);
+
+	return result == SDMMC_ASYNC_DONE;
+}
+
+static int _sdmmc_execute_cmd_start(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *blkcnt)
 {
 	int has_req_or_check_busy = req || cmd->check_busy;
 	if (!_sdmmc_wait_cmd_data_inhibit(sdmmc, has_req_or_check_busy))
 		return 0;
 
-	u32 blkcnt = 0;
 	bool is_data_present = false;
 	if (req)
 	{
-		if (!_sdmmc_config_sdma(sdmmc, &blkcnt, req))
+		if (!_sdmmc_config_dma(sdmmc, blkcnt, req))
 		{
 #ifdef ERROR_EXTRA_PRINTING
 			EPRINTFARGS("SDMMC%d: DMA Wrong cfg!", sdmmc->id + 1);
@@ -1141,6 +1218,9 @@ static int _sdmmc_execute_cmd_inner(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_
 		// Flush cache before starting the transfer.
 		bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLEAN_WAY, false);
 
+		sdmmc->dma_blkcnt  = *blkcnt;
+		sdmmc->dma_timeout = get_tmr_ms() + 1500;
+
 		is_data_present = true;
 	}
 
@@ -1161,55 +1241,69 @@ static int _sdmmc_execute_cmd_inner(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_
 #endif
 	DPRINTF("rsp(%d): %08X, %08X, %08X, %08X\n", result,
 		sdmmc->regs->rspreg0, sdmmc->regs->rspreg1, sdmmc->regs->rspreg2, sdmmc->regs->rspreg3);
-	if (result)
+	if (result && cmd->rsp_type)
 	{
-		if (cmd->rsp_type)
-		{
-			sdmmc->expected_rsp_type = cmd->rsp_type;
-			result = _sdmmc_cache_rsp(sdmmc, sdmmc->rsp, 0x10, cmd->rsp_type);
-#ifdef ERROR_EXTRA_PRINTING
-			if (!result)
-				EPRINTFARGS("SDMMC%d: Unknown response type!", sdmmc->id + 1);
-#endif
-		}
-		if (req && result)
-		{
-			result = _sdmmc_update_sdma(sdmmc);
+		sdmmc->expected_rsp_type = cmd->rsp_type;
+		result = _sdmmc_cache_rsp(sdmmc, sdmmc->rsp, 0x10, cmd->rsp_type);
 #ifdef ERROR_EXTRA_PRINTING
-			if (!result)
-				EPRINTFARGS("SDMMC%d: DMA Update failed!", sdmmc->id + 1);
+		if (!result)
+			EPRINTFARGS("SDMMC%d: Unknown response type!", sdmmc->id + 1);
 #endif
-		}
 	}
 
+	if (!result)
+		_sdmmc_mask_interrupts(sdmmc);
+
+	return result;
+}
+
+static int _sdmmc_execute_cmd_finish(sdmmc_t *sdmmc, bool check_busy, bool has_req, bool is_auto_stop_trn, u32 blkcnt, u32 *blkcnt_out)
+{
 	_sdmmc_mask_interrupts(sdmmc);
 
-	if (result)
+	if (has_req)
 	{
-		if (req)
-		{
-			// Invalidate cache after transfer.
-			bpmp_mmu_maintenance(BPMP_MMU_MAINT_INVALID_WAY, false);
+		// Invalidate cache after transfer.
+		bpmp_mmu_maintenance(BPMP_MMU_MAINT_INVALID_WAY, false);
 
-			if (blkcnt_out)
-				*blkcnt_out = blkcnt;
+		if (blkcnt_out)
+			*blkcnt_out = blkcnt;
 
-			if (req->is_auto_stop_trn)
-				sdmmc->rsp3 = sdmmc->regs->rspreg3;
-		}
+		if (is_auto_stop_trn)
+			sdmmc->rsp3 = sdmmc->regs->rspreg3;
+	}
 
-		if (cmd->check_busy || req)
-		{
-			result = _sdmmc_wait_card_busy(sdmmc);
+	if (check_busy || has_req)
+	{
+		int result = _sdmmc_wait_card_busy(sdmmc);
 #ifdef ERROR_EXTRA_PRINTING
-			if (!result)
-				EPRINTFARGS("SDMMC%d: Busy timeout!", sdmmc->id + 1);
+		if (!result)
+			EPRINTFARGS("SDMMC%d: Busy timeout!", sdmmc->id + 1);
 #endif
-			return result;
-		}
+		return result;
 	}
 
-	return result;
+	return 1;
+}
+
+static int _sdmmc_execute_cmd_inner(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *blkcnt_out)
+{
+	u32 blkcnt = 0;
+
+	if (!_sdmmc_execute_cmd_start(sdmmc, cmd, req, &blkcnt))
+		return 0;
+
+	if (req && !_sdmmc_update_dma(sdmmc))
+	{
+#ifdef ERROR_EXTRA_PRINTING
+		EPRINTFARGS("SDMMC%d: DMA Update failed!", sdmmc->id + 1);
+#endif
+		_sdmmc_mask_interrupts(sdmmc);
+
+		return 0;
+	}
+
+	return _sdmmc_execute_cmd_finish(sdmmc, cmd->check_busy, req != NULL, req && req->is_auto_stop_trn, blkcnt, blkcnt_out);
 }
 
 bool sdmmc_get_sd_inserted()
@@ -1515,7 +1609,8 @@ void sdmmc_init_cmd(sdmmc_cmd_t *cmdbuf, u16 cmd, u32 arg, u32 rsp_type, u32 che
 
 int sdmmc_execute_cmd(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *blkcnt_out)
 {
-	if (!sdmmc->card_clock_enabled)
+	// Can't interleave a command with an in-flight async transfer.
+	if (!sdmmc->card_clock_enabled || sdmmc->async.active)
 		return 0;
 
 	// Recalibrate periodically for SDMMC1.
@@ -1540,6 +1635,69 @@ int sdmmc_execute_cmd(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *b
 	return result;
 }
 
+int sdmmc_execute_cmd_async(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req)
+{
+	if (!sdmmc->card_clock_enabled || sdmmc->async.active)
+		return 0;
+
+	// Recalibrate periodically for SDMMC1.
+	if (sdmmc->manual_cal && sdmmc->powersave_enabled)
+		_sdmmc_autocal_execute(sdmmc, sdmmc_get_io_power(sdmmc));
+
+	sdmmc->async.disable_clock = 0;
+	if (!(sdmmc->regs->clkcon & SDHCI_CLOCK_CARD_EN))
+	{
+		sdmmc->async.disable_clock = 1;
+		sdmmc->regs->clkcon |= SDHCI_CLOCK_CARD_EN;
+		_sdmmc_commit_changes(sdmmc);
+		usleep((8 * 1000 + sdmmc->card_clock - 1) / sdmmc->card_clock); // Wait 8 cycles.
+	}
+
+	sdmmc->async.check_busy       = cmd->check_busy;
+	sdmmc->async.is_auto_stop_trn = req->is_auto_stop_trn;
+
+	// Only the command phase blocks. Data phase is driven by sdmmc_poll_cmd_async.
+	if (!_sdmmc_execute_cmd_start(sdmmc, cmd, req, &sdmmc->async.blkcnt))
+	{
+		usleep((8 * 1000 + sdmmc->card_clock - 1) / sdmmc->card_clock); // Wait 8 cycles.
+		if (sdmmc->async.disable_clock)
+			sdmmc->regs->clkcon &= ~SDHCI_CLOCK_CARD_EN;
+
+		return 0;
+	}
+
+	sdmmc->async.active = 1;
+
+	return 1;
+}
+
+int sdmmc_poll_cmd_async(sdmmc_t *sdmmc, u32 *blkcnt_out)
+{
+	if (!sdmmc->async.active)
+		return SDMMC_ASYNC_ERROR;
+
+	int result = _sdmmc_update_dma_step(sdmmc);
+	if (result == SDMMC_ASYNC_PENDING)
+		return result;
+
+	if (result == SDMMC_ASYNC_DONE)
+	{
+		if (!_sdmmc_execute_cmd_finish(sdmmc, sdmmc->async.check_busy, true, sdmmc->async.is_auto_stop_trn,
+			sdmmc->async.blkcnt, blkcnt_out))
+			result = SDMMC_ASYNC_ERROR;
+	}
+	else
+		_sdmmc_mask_interrupts(sdmmc);
+
+	usleep((8 * 1000 + sdmmc->card_clock - 1) / sdmmc->card_clock); // Wait 8 cycles.
+	if (sdmmc->async.disable_clock)
+		sdmmc->regs->clkcon &= ~SDHCI_CLOCK_CARD_EN;
+
+	sdmmc->async.active = 0;
+
+	return result;
+}
+
 int sdmmc_enable_low_voltage(sdmmc_t *sdmmc)
 {
 	if (sdmmc->id != SDMMC_1)
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2018 naehrwert
- * Copyright (c) 2018-2023 CTCaer
+ * Copyright (c) 2018-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -50,6 +50,11 @@
 #define SDMMC_MASKINT_NOERROR  1
 #define SDMMC_MASKINT_ERROR    2
 
+/*! SDMMC async request status. */
+#define SDMMC_ASYNC_DONE    0
+#define SDMMC_ASYNC_PENDING 1
+#define SDMMC_ASYNC_ERROR   2
+
 /*! SDMMC present state. 0x24. */
 #define SDHCI_CMD_INHIBIT      BIT(0)
 #define SDHCI_DATA_INHIBIT     BIT(1)
@@ -277,6 +282,36 @@
 #define INVALID_TAP              0x100
 #define SAMPLING_WINDOW_SIZE_MIN 8
 
+/*! SDMMC ADMA2 descriptor. 128-bit, since Host V4 and 64-bit addressing are used. */
+#define SDMMC_ADMA2_VALID    BIT(0)
+#define SDMMC_ADMA2_END      BIT(1)
+#define SDMMC_ADMA2_INT      BIT(2)
+#define SDMMC_ADMA2_ACT_NOP  (0U << 4)
+#define SDMMC_ADMA2_ACT_TRAN (2U << 4)
+#define SDMMC_ADMA2_ACT_LINK (3U << 4)
+
+#define SDMMC_ADMA2_MAX_LEN  SZ_32K
+#define SDMMC_ADMA2_DESC_NUM 1024 // 32MB with max length descriptors.
+
+typedef struct _sdmmc_adma2_desc_t
+{
+	u16 attr;
+	u16 len;
+	u32 addr;
+	u32 addr_hi;
+	u32 rsvd;
+} sdmmc_adma2_desc_t;
+
+/*! SDMMC in-flight async request. */
+typedef struct _sdmmc_async_t
+{
+	int active;
+	int disable_clock;
+	u32 check_busy;
+	int is_auto_stop_trn;
+	u32 blkcnt;
+} sdmmc_async_t;
+
 /*! SDMMC controller context. */
 typedef struct _sdmmc_t
 {
@@ -291,6 +326,10 @@ typedef struct _sdmmc_t
 	u32 venclkctl_tap;
 	u32 expected_rsp_type;
 	u32 dma_addr_next;
+	u32 dma_blkcnt;
+	u32 dma_timeout;
+	sdmmc_adma2_desc_t *adma_desc;
+	sdmmc_async_t async;
 	u32 rsp[4];
 	u32 rsp3;
 	int t210b01;
@@ -320,6 +359,8 @@ int  sdmmc_get_io_power(sdmmc_t *sdmmc);
 u32  sdmmc_get_bus_width(sdmmc_t *sdmmc);
 void sdmmc_set_bus_width(sdmmc_t *sdmmc, u32 bus_width);
 void sdmmc_save_tap_value(sdmmc_t *sdmmc);
+u32  sdmmc_get_tap_value(sdmmc_t *sdmmc);
+void sdmmc_set_tap_value(sdmmc_t *sdmmc, u32 tap);
 void sdmmc_setup_drv_type(sdmmc_t *sdmmc, u32 type);
 int  sdmmc_setup_clock(sdmmc_t *sdmmc, u32 type);
 void sdmmc_card_clock_powersave(sdmmc_t *sdmmc, int powersave_enable);
@@ -331,6 +372,8 @@ int  sdmmc_init(sdmmc_t *sdmmc, u32 id, u32 power, u32 bus_width, u32 type);
 void sdmmc_end(sdmmc_t *sdmmc);
 void sdmmc_init_cmd(sdmmc_cmd_t *cmdbuf, u16 cmd, u32 arg, u32 rsp_type, u32 check_busy);
 int  sdmmc_execute_cmd(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req, u32 *blkcnt_out);
+int  sdmmc_execute_cmd_async(sdmmc_t *sdmmc, sdmmc_cmd_t *cmd, sdmmc_req_t *req);
+int  sdmmc_poll_cmd_async(sdmmc_t *sdmmc, u32 *blkcnt_out);
 int  sdmmc_enable_low_voltage(sdmmc_t *sdmmc);
 
 #endif
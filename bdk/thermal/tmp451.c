@@ -1,7 +1,7 @@
 /*
  * SOC/PCB Temperature driver for Nintendo Switch's TI TMP451
  *
- * Copyright (c) 2018-2020 CTCaer
+ * Copyright (c) 2018-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -53,24 +53,45 @@ u16 tmp451_get_pcb_temp(bool intenger)
 	return temp;
 }
 
-void tmp451_init()
+static void _tmp451_get_soc_offset(u8 *ofh, u8 *ofl)
 {
-	// Disable ALARM and Range to 0 - 127 oC.
-	i2c_send_byte(I2C_1, TMP451_I2C_ADDR, TMP451_CONFIG_REG, 0x80);
-
 	// Set remote sensor offsets based on SoC.
 	if (hw_get_chip_id() == GP_HIDREV_MAJOR_T210)
 	{
 		// Set offset to 0 oC for Erista.
-		i2c_send_byte(I2C_1, TMP451_I2C_ADDR, TMP451_SOC_TMP_OFH_REG, 0);
-		i2c_send_byte(I2C_1, TMP451_I2C_ADDR, TMP451_SOC_TMP_OFL_REG, 0);
+		*ofh = 0;
+		*ofl = 0;
 	}
 	else
 	{
 		// Set offset to -12.5 oC for Mariko.
-		i2c_send_byte(I2C_1, TMP451_I2C_ADDR, TMP451_SOC_TMP_OFH_REG, 0xF3); // - 13  oC.
-		i2c_send_byte(I2C_1, TMP451_I2C_ADDR, TMP451_SOC_TMP_OFL_REG, 0x80); // + 0.5 oC.
+		*ofh = 0xF3; // - 13  oC.
+		*ofl = 0x80; // + 0.5 oC.
 	}
+}
+
+bool tmp451_is_configured()
+{
+	u8 ofh, ofl;
+	_tmp451_get_soc_offset(&ofh, &ofl);
+
+	// Check for running mode, range 0 - 127 oC and our SoC offset.
+	return i2c_recv_byte(I2C_1, TMP451_I2C_ADDR, TMP451_CONFIG_REG)      == 0x80 &&
+		   i2c_recv_byte(I2C_1, TMP451_I2C_ADDR, TMP451_SOC_TMP_OFH_REG) == ofh  &&
+		   i2c_recv_byte(I2C_1, TMP451_I2C_ADDR, TMP451_SOC_TMP_OFL_REG) == ofl;
+}
+
+void tmp451_init()
+{
+	u8 ofh, ofl;
+
+	// Disable ALARM and Range to 0 - 127 oC.
+	i2c_send_byte(I2C_1, TMP451_I2C_ADDR, TMP451_CONFIG_REG, 0x80);
+
+	// Set remote sensor offsets based on SoC.
+	_tmp451_get_soc_offset(&ofh, &ofl);
+	i2c_send_byte(I2C_1, TMP451_I2C_ADDR, TMP451_SOC_TMP_OFH_REG, ofh);
+	i2c_send_byte(I2C_1, TMP451_I2C_ADDR, TMP451_SOC_TMP_OFL_REG, ofl);
 
 	// Set conversion rate to 32/s and make a read to update the reg.
 	i2c_send_byte(I2C_1, TMP451_I2C_ADDR, TMP451_CNV_RATE_REG, 9);
@@ -40,6 +40,7 @@
 // Otherwise it's an integer oC.
 u16 tmp451_get_soc_temp(bool integer);
 u16 tmp451_get_pcb_temp(bool integer);
+bool tmp451_is_configured();
 void tmp451_init();
 void tmp451_end();
 
@@ -4,7 +4,7 @@
  * Copyright (c) 2003-2008 Alan Stern
  * Copyright (c) 2009 Samsung Electronics
  *                    Author: Michal Nazarewicz <m.nazarewicz@samsung.com>
- * Copyright (c) 2019-2023 CTCaer
+ * Copyright (c) 2019-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -53,10 +53,10 @@
 #define UMS_DISK_LBA_SHIFT 9
 #define UMS_DISK_LBA_SIZE  (1 << UMS_DISK_LBA_SHIFT)
 
-#define UMS_DISK_MAX_IO_TRANSFER_64K (USB_EP_BUFFER_MAX_SIZE >> UMS_DISK_LBA_SHIFT)
-#define UMS_DISK_MAX_IO_TRANSFER_32K (UMS_DISK_MAX_IO_TRANSFER_64K / 2)
-
-#define UMS_SCSI_TRANSFER_512K (0x80000 >> UMS_DISK_LBA_SHIFT)
+#define UMS_READ_CHUNK_SZ  SZ_512K
+#define UMS_READ_CHUNK_SCT (UMS_READ_CHUNK_SZ >> UMS_DISK_LBA_SHIFT)
+#define UMS_READ_RING      4                  // Queued SDMMC reads.
+#define UMS_READ_BUFS      (UMS_READ_RING + 1) // Plus the one the USB is sending.
 
 #define UMS_EP_OUT_MAX_XFER (USB_EP_BULK_OUT_MAX_XFER)
 
@@ -228,6 +228,15 @@ typedef struct _usbd_gadget_ums_t {
 	u32 timeouts;
 	bool xusb;
 
+	// SDMMC read ring. Buffers are sent directly by the bulk IN endpoint.
+	sdmmc_storage_req_t rd_req[UMS_READ_RING];
+	u32 rd_head;     // Oldest queued read.
+	u32 rd_head_off; // Sectors of the oldest read already sent.
+	u32 rd_cnt;
+	u32 rd_buf_idx;
+	u32 rd_lba;      // Next LBA to queue.
+	u32 rd_last_end; // End LBA of the last read command. Used for sequential detection.
+
 	void (*system_maintenance)(bool);
 	void *label;
 	void (*set_text)(void *, const char *);
@@ -376,6 +385,14 @@ static void _transfer_finish(usbd_gadget_ums_t *ums, bulk_ctxt_t *bulk_ctxt, u32
 		bulk_ctxt->bulk_in_status = usb_ops.usb_device_ep1_in_writing_finish(
 			&bulk_ctxt->bulk_in_length_actual, sync_timeout);
 
+		// Keep queued SDMMC reads going while the USB sends.
+		while (sync_timeout == USB_XFER_POLL && bulk_ctxt->bulk_in_status == USB_ERROR_TIMEOUT)
+		{
+			sdmmc_storage_poll(ums->lun.storage);
+			bulk_ctxt->bulk_in_status = usb_ops.usb_device_ep1_in_writing_finish(
+				&bulk_ctxt->bulk_in_length_actual, sync_timeout);
+		}
+
 		if (bulk_ctxt->bulk_in_status == USB_ERROR_XFER_ERROR)
 		{
 			ums->set_text(ums->label, "#FFDD00 Error:# EP IN transfer!");
@@ -438,11 +455,81 @@ static void _reset_buffer(bulk_ctxt_t *bulk_ctxt, u32 ep)
  *  --.- --/-,  23.8 MB/s,  27.2 MB/s, 25.8 MB/s, 17.5 MB/s - SCSI  64KB, Concurrency.
  */
 
+static void _ums_read_queue(usbd_gadget_ums_t *ums, u32 amount)
+{
+	sdmmc_storage_req_t *req = &ums->rd_req[(ums->rd_head + ums->rd_cnt) % UMS_READ_RING];
+
+	req->sector      = ums->lun.offset + ums->rd_lba;
+	req->num_sectors = amount;
+	req->buf         = (u8 *)SDXC_BUF_ALIGNED + ums->rd_buf_idx * UMS_READ_CHUNK_SZ;
+	req->is_write    = 0;
+	req->complete    = NULL;
+
+	if (!sdmmc_storage_submit(ums->lun.storage, req))
+		req->status = SDMMC_REQ_FAILED;
+
+	ums->rd_buf_idx = (ums->rd_buf_idx + 1) % UMS_READ_BUFS;
+	ums->rd_lba += amount;
+	ums->rd_cnt++;
+}
+
+static void _ums_read_fill(usbd_gadget_ums_t *ums, u32 lba_end, bool sequential)
+{
+	// Queue whole chunks when the host reads sequentially, so they also serve the next commands.
+	while (ums->rd_cnt < UMS_READ_RING && ums->rd_lba < lba_end)
+	{
+		u32 amount = sequential ? ums->lun.num_sectors - ums->rd_lba : lba_end - ums->rd_lba;
+		_ums_read_queue(ums, MIN(amount, UMS_READ_CHUNK_SCT));
+	}
+}
+
+static sdmmc_storage_req_t *_ums_read_wait(usbd_gadget_ums_t *ums)
+{
+	sdmmc_storage_req_t *req = &ums->rd_req[ums->rd_head];
+
+	while (req->status != SDMMC_REQ_DONE && req->status != SDMMC_REQ_FAILED)
+		sdmmc_storage_poll(ums->lun.storage);
+
+	return req;
+}
+
+static void _ums_read_consume(usbd_gadget_ums_t *ums, u32 amount)
+{
+	ums->rd_head_off += amount;
+	if (ums->rd_head_off < ums->rd_req[ums->rd_head].num_sectors)
+		return;
+
+	ums->rd_head     = (ums->rd_head + 1) % UMS_READ_RING;
+	ums->rd_head_off = 0;
+	ums->rd_cnt--;
+}
+
+static void _ums_read_drain(usbd_gadget_ums_t *ums)
+{
+	// Drop reads that didn't start. Only the one in flight must finish before its buffer is reused.
+	for (u32 i = 0; i < ums->rd_cnt; i++)
+		sdmmc_storage_cancel(ums->lun.storage, &ums->rd_req[(ums->rd_head + i) % UMS_READ_RING]);
+
+	while (ums->rd_cnt)
+	{
+		sdmmc_storage_req_t *req = _ums_read_wait(ums);
+		_ums_read_consume(ums, req->num_sectors - ums->rd_head_off);
+	}
+
+	ums->rd_last_end = 0;
+}
+
+/*
+ * SDMMC reads are queued in a ring of 512KB chunks and the bulk IN endpoint sends
+ * straight from them, so the card reads the next chunk while the USB sends the current.
+ * When the host reads sequentially, whole chunks are read ahead and serve the next
+ * commands. XUSB sends up to 512KB per transfer. USB2 is limited to 64KB.
+ */
 static int _scsi_read(usbd_gadget_ums_t *ums, bulk_ctxt_t *bulk_ctxt)
 {
 	u32 lba_offset;
-	bool first_read = true;
-	u8 *sdmmc_buf = (u8 *)SDXC_BUF_ALIGNED;
+	bool usb_pending = false;
+	u32 usb_max_xfer = ums->xusb ? USB_EP_BULK_IN_MAX_XFER_XUSB : USB_EP_BUFFER_MAX_SIZE;
 
 	// Get the starting LBA and check that it's not too big.
 	if (ums->cmnd[0] == SC_READ_6)
@@ -472,19 +559,26 @@ static int _scsi_read(usbd_gadget_ums_t *ums, bulk_ctxt_t *bulk_ctxt)
 	if (!amount_left)
 		return UMS_RES_IO_ERROR; // No default reply.
 
-	// Limit IO transfers based on request for faster concurrent reads.
-	u32 max_io_transfer = (amount_left >= UMS_SCSI_TRANSFER_512K) ?
-						  UMS_DISK_MAX_IO_TRANSFER_64K : UMS_DISK_MAX_IO_TRANSFER_32K;
+	u32  lba_end    = MIN(lba_offset + amount_left, ums->lun.num_sectors);
+	bool sequential = lba_offset == ums->rd_last_end;
+
+	// Drop read ahead data if the host went elsewhere.
+	if (ums->rd_cnt && (ums->rd_req[ums->rd_head].sector - ums->lun.offset + ums->rd_head_off) != lba_offset)
+		_ums_read_drain(ums);
+	if (!ums->rd_cnt)
+		ums->rd_lba = lba_offset;
+	ums->rd_last_end = lba_offset + amount_left;
 
 	while (true)
 	{
-		// Max io size and end sector limits.
-		u32 amount = MIN(amount_left, max_io_transfer);
-		amount     = MIN(amount, ums->lun.num_sectors - lba_offset);
+		_ums_read_fill(ums, lba_end, sequential);
 
 		// Check if it is a read past the end sector.
-		if (!amount)
+		if (!ums->rd_cnt)
 		{
+			if (usb_pending)
+				_transfer_finish(ums, bulk_ctxt, bulk_ctxt->bulk_in, USB_XFER_POLL);
+
 			ums->lun.sense_data      = SS_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE;
 			ums->lun.sense_data_info = lba_offset;
 			ums->lun.info_valid      = 1;
@@ -494,42 +588,71 @@ static int _scsi_read(usbd_gadget_ums_t *ums, bulk_ctxt_t *bulk_ctxt)
 			break;
 		}
 
-		// Do the SDMMC read.
-		if (!sdmmc_storage_read(ums->lun.storage, ums->lun.offset + lba_offset, amount, sdmmc_buf))
-			amount = 0;
-
-		// Wait for the async USB transfer to finish.
-		if (!first_read)
-			_transfer_finish(ums, bulk_ctxt, bulk_ctxt->bulk_in, USB_XFER_SYNCED);
-
-		lba_offset   += amount;
-		amount_left  -= amount;
-		ums->residue -= amount << UMS_DISK_LBA_SHIFT;
-
-		bulk_ctxt->bulk_in_length    = amount << UMS_DISK_LBA_SHIFT;
-		bulk_ctxt->bulk_in_buf_state = BUF_STATE_FULL;
-		bulk_ctxt->bulk_in_buf       = sdmmc_buf;
+		// Wait for the oldest SDMMC read.
+		sdmmc_storage_req_t *req = _ums_read_wait(ums);
+		u32 amount = MIN(req->num_sectors - ums->rd_head_off, amount_left);
+		u8 *buf = (u8 *)req->buf + (ums->rd_head_off << UMS_DISK_LBA_SHIFT);
 
 		// If an error occurred, report it and its position.
-		if (!amount)
+		if (req->status == SDMMC_REQ_FAILED)
 		{
+			if (usb_pending)
+				_transfer_finish(ums, bulk_ctxt, bulk_ctxt->bulk_in, USB_XFER_POLL);
+			_ums_read_drain(ums);
+
 			ums->set_text(ums->label, "#FFDD00 Error:# SDMMC Read!");
 			ums->lun.sense_data      = SS_UNRECOVERED_READ_ERROR;
 			ums->lun.sense_data_info = lba_offset;
 			ums->lun.info_valid      = 1;
+
+			bulk_ctxt->bulk_in_length    = 0;
+			bulk_ctxt->bulk_in_buf_state = BUF_STATE_FULL;
 			break;
 		}
 
-		// Last SDMMC read. Last part will be sent by the finish reply function.
-		if (!amount_left)
-			break;
+		lba_offset   += amount;
+		amount_left  -= amount;
+		ums->residue -= amount << UMS_DISK_LBA_SHIFT;
+
+		u32 len = amount << UMS_DISK_LBA_SHIFT;
+		while (len)
+		{
+			u32 xfer_len = MIN(len, usb_max_xfer);
+
+			// The finish reply function sends the last part and that is limited to 64KB.
+			if (!amount_left && xfer_len == len && len > USB_EP_BUFFER_MAX_SIZE)
+				xfer_len = len - USB_EP_BUFFER_MAX_SIZE;
+
+			// Wait for the async USB transfer to finish.
+			if (usb_pending)
+				_transfer_finish(ums, bulk_ctxt, bulk_ctxt->bulk_in, USB_XFER_POLL);
+			usb_pending = false;
+
+			bulk_ctxt->bulk_in_length    = xfer_len;
+			bulk_ctxt->bulk_in_buf_state = BUF_STATE_FULL;
+			bulk_ctxt->bulk_in_buf       = buf;
+
+			len -= xfer_len;
+			buf += xfer_len;
+
+			// Last USB transfer. It will be sent by the finish reply function.
+			if (!len && !amount_left)
+				break;
+
+			// Start the USB transfer.
+			_transfer_start(ums, bulk_ctxt, bulk_ctxt->bulk_in, USB_XFER_START);
+			usb_pending = true;
+		}
 
-		// Start the USB transfer.
-		_transfer_start(ums, bulk_ctxt, bulk_ctxt->bulk_in, USB_XFER_START);
-		first_read = false;
+		_ums_read_consume(ums, amount);
 
-		// Increment our buffer to read new data.
-		sdmmc_buf += amount << UMS_DISK_LBA_SHIFT;
+		if (!amount_left)
+		{
+			// Keep the card busy while the host processes the reply.
+			if (sequential)
+				_ums_read_fill(ums, MIN(lba_end + UMS_READ_CHUNK_SCT, ums->lun.num_sectors), true);
+			break;
+		}
 	}
 
 	return UMS_RES_IO_ERROR; // No default reply.
@@ -549,6 +672,9 @@ static int _scsi_write(usbd_gadget_ums_t *ums, bulk_ctxt_t *bulk_ctxt)
 	u32 usb_lba_offset, lba_offset;
 	u32 amount;
 
+	// Drop read ahead data, since it can be overwritten.
+	_ums_read_drain(ums);
+
 	if (ums->lun.ro)
 	{
 		ums->set_text(ums->label, "#FF8000 Warn:# Write - Read only! Host notified.");
@@ -1942,6 +2068,8 @@ int usb_device_gadget_ums(usb_ctxt_t *usbs)
 		_send_status(&ums, &ums.bulk_ctxt);
 	} while (ums.state != UMS_STATE_TERMINATED);
 
+	_ums_read_drain(&ums);
+
 	if (ums.lun.prevent_medium_removal)
 		ums.set_text(ums.label, "#FFDD00 Error:# Disk unsafely ejected");
 	else
@@ -1954,7 +2082,11 @@ usb_enum_error:
 
 exit:
 	if (ums.lun.type == MMC_EMMC)
+	{
+		// Host writes bypass the raw block cache.
+		emmc_cache_reset();
 		emmc_end();
+	}
 
 init_fail:
 	usb_ops.usbd_end(true, false);
@@ -1531,6 +1531,10 @@ int usb_device_ep1_in_writing_finish(u32 *pending_bytes, u32 sync_timeout)
 			break;
 
 		usbd_handle_ep0_ctrl_setup();
+
+		// Return to caller if it only polls.
+		if (sync_timeout == USB_XFER_POLL && ep_status == USB_EP_STATUS_ACTIVE)
+			return USB_ERROR_TIMEOUT;
 	}
 	while ((ep_status == USB_EP_STATUS_ACTIVE) || (ep_status == USB_EP_STATUS_STALLED));
 
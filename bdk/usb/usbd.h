@@ -30,7 +30,10 @@
 #define USB_EP_BUFFER_MAX_SIZE  (USB_EP_BUFFER_4_TD)
 #define USB_EP_BUFFER_ALIGN     (USB_TD_BUFFER_PAGE_SIZE)
 
+#define USB_EP_BULK_IN_MAX_XFER_XUSB (USB_EP_BUFFER_MAX_SIZE * 8) // One normal TRB per 64KB.
+
 #define USB_XFER_START        0
+#define USB_XFER_POLL         1 // Finish only. Returns USB_ERROR_TIMEOUT if still active.
 #define USB_XFER_SYNCED_ENUM  1000000
 #define USB_XFER_SYNCED_CMD   1000000
 #define USB_XFER_SYNCED_DATA  2000000
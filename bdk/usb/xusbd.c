@@ -1,7 +1,7 @@
 /*
  * eXtensible USB Device driver (XDCI) for Tegra X1
  *
- * Copyright (c) 2020-2022 CTCaer
+ * Copyright (c) 2020-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -2095,8 +2095,8 @@ int xusb_device_ep1_out_reading_finish(u32 *pending_bytes, u32 sync_tries)
 
 int xusb_device_ep1_in_write(u8 *buf, u32 len, u32 *bytes_written, u32 sync_tries)
 {
-	if (len > USB_EP_BUFFER_MAX_SIZE)
-		len = USB_EP_BUFFER_MAX_SIZE;
+	if (len > USB_EP_BULK_IN_MAX_XFER_XUSB)
+		len = USB_EP_BULK_IN_MAX_XFER_XUSB;
 
 	// Flush data before transfer.
 	bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLEAN_WAY, false);
@@ -2105,8 +2105,15 @@ int xusb_device_ep1_in_write(u8 *buf, u32 len, u32 *bytes_written, u32 sync_trie
 	usbd_xotg->tx_count[USB_DIR_IN] = 0;
 	usbd_xotg->tx_bytes[USB_DIR_IN] = len;
 
-	_xusb_issue_normal_trb(buf, len, USB_DIR_IN);
-	usbd_xotg->tx_count[USB_DIR_IN]++;
+	// Queue one TRB per 64KB. Each one completes on its own event.
+	u32 offset = 0;
+	do
+	{
+		u32 trb_len = MIN(len - offset, USB_EP_BUFFER_MAX_SIZE);
+		_xusb_issue_normal_trb(buf + offset, trb_len, USB_DIR_IN);
+		usbd_xotg->tx_count[USB_DIR_IN]++;
+		offset += trb_len;
+	} while (offset < len);
 
 	if (sync_tries)
 	{
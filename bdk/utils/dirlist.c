@@ -23,15 +23,33 @@
 
 #define MAX_ENTRIES 64
 
+static void _dirlist_insert(char *dir_entries, u8 *order, u32 k)
+{
+	// Binary search for the ASCII ordered position of the new entry.
+	u32 lo = 0, hi = k;
+	while (lo < hi)
+	{
+		u32 mid = (lo + hi) >> 1;
+		if (strcmp(&dir_entries[order[mid] * 256], &dir_entries[k * 256]) > 0)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	// Only move indices. Entries are copied once in order at the end.
+	memmove(&order[lo + 1], &order[lo], k - lo);
+	order[lo] = k;
+}
+
 char *dirlist(const char *directory, const char *pattern, bool includeHiddenFiles, bool parse_dirs)
 {
 	int res = 0;
-	u32 i = 0, j = 0, k = 0;
+	u32 i = 0, k = 0;
 	DIR dir;
 	FILINFO fno;
+	u8 order[MAX_ENTRIES];
 
 	char *dir_entries = (char *)calloc(MAX_ENTRIES, 256);
-	char *temp = (char *)calloc(1, 256);
 
 	if (!pattern && !f_opendir(&dir, directory))
 	{
@@ -48,6 +66,7 @@ char *dirlist(const char *directory, const char *pattern, bool includeHiddenFile
 				if ((fno.fname[0] != '.') && (includeHiddenFiles || !(fno.fattrib & AM_HID)))
 				{
 					strcpy(dir_entries + (k * 256), fno.fname);
+					_dirlist_insert(dir_entries, order, k);
 					k++;
 					if (k > (MAX_ENTRIES - 1))
 						break;
@@ -63,6 +82,7 @@ char *dirlist(const char *directory, const char *pattern, bool includeHiddenFile
 			if (!(fno.fattrib & AM_DIR) && (fno.fname[0] != '.') && (includeHiddenFiles || !(fno.fattrib & AM_HID)))
 			{
 				strcpy(dir_entries + (k * 256), fno.fname);
+				_dirlist_insert(dir_entries, order, k);
 				k++;
 				if (k > (MAX_ENTRIES - 1))
 					break;
@@ -74,27 +94,17 @@ char *dirlist(const char *directory, const char *pattern, bool includeHiddenFile
 
 	if (!k)
 	{
-		free(temp);
 		free(dir_entries);
 
 		return NULL;
 	}
 
-	// Reorder ini files by ASCII ordering.
-	for (i = 0; i < k - 1 ; i++)
-	{
-		for (j = i + 1; j < k; j++)
-		{
-			if (strcmp(&dir_entries[i * 256], &dir_entries[j * 256]) > 0)
-			{
-				strcpy(temp, &dir_entries[i * 256]);
-				strcpy(&dir_entries[i * 256], &dir_entries[j * 256]);
-				strcpy(&dir_entries[j * 256], temp);
-			}
-		}
-	}
+	// Copy entries in ASCII ordering.
+	char *sorted_entries = (char *)calloc(MAX_ENTRIES, 256);
+	for (i = 0; i < k; i++)
+		strcpy(&sorted_entries[i * 256], &dir_entries[order[i] * 256]);
 
-	free(temp);
+	free(dir_entries);
 
-	return dir_entries;
+	return sorted_entries;
 }
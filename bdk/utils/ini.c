@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2018 naehrwert
- * Copyright (c) 2018-2022 CTCaer
+ * Copyright (c) 2018-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -20,6 +20,7 @@
 #include "ini.h"
 #include <libs/fatfs/ff.h>
 #include <mem/heap.h>
+#include <storage/sd.h>
 #include <utils/dirlist.h>
 #include <utils/util.h>
 
@@ -173,6 +174,251 @@ int ini_parse(link_t *dst, char *ini_path, bool is_dir)
 	return 1;
 }
 
+static u32 _ini_fno_crc32(u32 crc, FILINFO *fno)
+{
+	crc = crc32_calc(crc, (u8 *)&fno->fsize, sizeof(fno->fsize));
+	crc = crc32_calc(crc, (u8 *)&fno->fdate, sizeof(fno->fdate));
+	crc = crc32_calc(crc, (u8 *)&fno->ftime, sizeof(fno->ftime));
+
+	return crc;
+}
+
+static int _ini_source_crc32(char *ini_path, bool is_dir, u32 *crc)
+{
+	DIR dir;
+	FILINFO fno;
+
+	*crc = 0;
+
+	// Only directory metadata is read. Writers invalidate the snapshot via ini_cache_invalidate().
+	if (!is_dir)
+	{
+		if (f_stat(ini_path, &fno))
+			return 0;
+
+		*crc = _ini_fno_crc32(*crc, &fno);
+
+		return 1;
+	}
+
+	// Use the same filtering as dirlist. Any rename, addition or removal changes the result.
+	if (f_findfirst(&dir, &fno, ini_path, "*.ini"))
+		return 0;
+
+	while (fno.fname[0])
+	{
+		if (!(fno.fattrib & AM_DIR) && (fno.fname[0] != '.') && !(fno.fattrib & AM_HID))
+		{
+			*crc = crc32_calc(*crc, (u8 *)fno.fname, strlen(fno.fname));
+			*crc = _ini_fno_crc32(*crc, &fno);
+		}
+
+		if (f_findnext(&dir, &fno))
+			break;
+	}
+	f_closedir(&dir);
+
+	return 1;
+}
+
+static char *_ini_cache_str(u8 *buf, u32 off, u32 size)
+{
+	if (off >= size)
+		return NULL;
+
+	// Make sure that string is terminated inside the snapshot.
+	if (strnlen((char *)buf + off, size - off) == size - off)
+		return NULL;
+
+	return (char *)buf + off;
+}
+
+static bool _ini_cache_next_valid(u32 *off, u32 next)
+{
+	// Records must move forward and stay word aligned.
+	if (next <= *off || (next & 3))
+		return false;
+
+	*off = next;
+
+	return true;
+}
+
+static int _ini_cache_load(link_t *dst, const char *cache_path, u32 src_crc32)
+{
+	u32 size;
+	u8 *buf = sd_file_read(cache_path, &size);
+	if (!buf)
+		return 0;
+
+	ini_cache_hdr_t *hdr = (ini_cache_hdr_t *)buf;
+	if (size < sizeof(ini_cache_hdr_t) || hdr->magic != INI_CACHE_MAGIC || hdr->version != INI_CACHE_VERSION ||
+		hdr->size != size || hdr->src_crc32 != src_crc32)
+		goto error;
+
+	// Validate all records before touching any list.
+	u32 off = sizeof(ini_cache_hdr_t);
+	for (u32 i = 0; i < hdr->sec_cnt; i++)
+	{
+		if (off + sizeof(u32) + sizeof(ini_sec_t) > size)
+			goto error;
+
+		u32 kv_cnt = *(u32 *)(buf + off);
+		ini_sec_t *sec = (ini_sec_t *)(buf + off + sizeof(u32));
+		if (sec->name && !_ini_cache_str(buf, (u32)sec->name, size))
+			goto error;
+		if (!_ini_cache_next_valid(&off, (u32)sec->link.next))
+			goto error;
+
+		for (u32 j = 0; j < kv_cnt; j++)
+		{
+			if (off + sizeof(ini_kv_t) > size)
+				goto error;
+
+			ini_kv_t *kv = (ini_kv_t *)(buf + off);
+			if (!_ini_cache_str(buf, (u32)kv->key, size) || !_ini_cache_str(buf, (u32)kv->val, size))
+				goto error;
+			if (!_ini_cache_next_valid(&off, (u32)kv->link.next))
+				goto error;
+		}
+	}
+
+	// Relocate records in place and link them.
+	off = sizeof(ini_cache_hdr_t);
+	for (u32 i = 0; i < hdr->sec_cnt; i++)
+	{
+		u32 kv_cnt = *(u32 *)(buf + off);
+		ini_sec_t *sec = (ini_sec_t *)(buf + off + sizeof(u32));
+		off = (u32)sec->link.next;
+
+		if (sec->name)
+			sec->name = (char *)buf + (u32)sec->name;
+		sec->arena = buf;
+		list_init(&sec->kvs);
+
+		for (u32 j = 0; j < kv_cnt; j++)
+		{
+			ini_kv_t *kv = (ini_kv_t *)(buf + off);
+			off = (u32)kv->link.next;
+
+			kv->key = (char *)buf + (u32)kv->key;
+			kv->val = (char *)buf + (u32)kv->val;
+			list_append(&sec->kvs, &kv->link);
+		}
+
+		list_append(dst, &sec->link);
+	}
+
+	// Free buffer if snapshot was empty, since no section owns it.
+	if (!hdr->sec_cnt)
+		free(buf);
+
+	return 1;
+
+error:
+	free(buf);
+
+	return 0;
+}
+
+static u32 _ini_cache_str_size(char *str)
+{
+	return str ? ALIGN(strlen(str) + 1, 4) : 0;
+}
+
+static char *_ini_cache_str_copy(u8 *buf, u32 *off, char *str)
+{
+	if (!str)
+		return NULL;
+
+	char *rel = (char *)*off;
+	strcpy((char *)buf + *off, str);
+	*off += _ini_cache_str_size(str);
+
+	return rel;
+}
+
+static void _ini_cache_save(link_t *src, const char *cache_path, u32 src_crc32)
+{
+	u32 sec_cnt = 0;
+	u32 size = sizeof(ini_cache_hdr_t);
+
+	// Calculate snapshot size.
+	LIST_FOREACH_ENTRY(ini_sec_t, ini_sec, src, link)
+	{
+		sec_cnt++;
+		size += sizeof(u32) + sizeof(ini_sec_t) + _ini_cache_str_size(ini_sec->name);
+		LIST_FOREACH_ENTRY(ini_kv_t, kv, &ini_sec->kvs, link)
+			size += sizeof(ini_kv_t) + _ini_cache_str_size(kv->key) + _ini_cache_str_size(kv->val);
+	}
+
+	u8 *buf = calloc(size, 1);
+	ini_cache_hdr_t *hdr = (ini_cache_hdr_t *)buf;
+	hdr->magic     = INI_CACHE_MAGIC;
+	hdr->version   = INI_CACHE_VERSION;
+	hdr->size      = size;
+	hdr->src_crc32 = src_crc32;
+	hdr->sec_cnt   = sec_cnt;
+
+	// Serialize records. Pointers are stored as offsets and next links as the offset of the next record.
+	u32 off = sizeof(ini_cache_hdr_t);
+	LIST_FOREACH_ENTRY(ini_sec_t, ini_sec, src, link)
+	{
+		u32 *kv_cnt = (u32 *)(buf + off);
+		ini_sec_t *sec = (ini_sec_t *)(buf + off + sizeof(u32));
+		off += sizeof(u32) + sizeof(ini_sec_t);
+
+		sec->type  = ini_sec->type;
+		sec->color = ini_sec->color;
+		sec->name  = _ini_cache_str_copy(buf, &off, ini_sec->name);
+		sec->link.next = (link_t *)off;
+
+		LIST_FOREACH_ENTRY(ini_kv_t, ini_kv, &ini_sec->kvs, link)
+		{
+			(*kv_cnt)++;
+			ini_kv_t *kv = (ini_kv_t *)(buf + off);
+			off += sizeof(ini_kv_t);
+
+			kv->key = _ini_cache_str_copy(buf, &off, ini_kv->key);
+			kv->val = _ini_cache_str_copy(buf, &off, ini_kv->val);
+			kv->link.next = (link_t *)off;
+		}
+	}
+
+	sd_save_to_file(buf, size, cache_path);
+
+	free(buf);
+}
+
+int ini_parse_cached(link_t *dst, char *ini_path, bool is_dir, const char *cache_path)
+{
+	u32 src_crc32;
+
+	// Get source state. If it doesn't exist, let the parser handle it.
+	if (!_ini_source_crc32(ini_path, is_dir, &src_crc32))
+		return ini_parse(dst, ini_path, is_dir);
+
+	// Use snapshot if it matches the source.
+	if (_ini_cache_load(dst, cache_path, src_crc32))
+		return 1;
+
+	// Parse into a separate list, so only this source gets saved.
+	LIST_INIT(ini_sections);
+	int res = ini_parse(&ini_sections, ini_path, is_dir);
+	if (res)
+		_ini_cache_save(&ini_sections, cache_path, src_crc32);
+
+	LIST_FOREACH_SAFE(iter, &ini_sections)
+		list_append(dst, iter);
+
+	return res;
+}
+
+void ini_cache_invalidate(const char *cache_path)
+{
+	f_unlink(cache_path);
+}
+
 char *ini_check_special_section(ini_sec_t *cfg)
 {
 	if (cfg == NULL)
@@ -191,6 +437,7 @@ char *ini_check_special_section(ini_sec_t *cfg)
 
 void ini_free(link_t *src)
 {
+	void *arena = NULL;
 	ini_sec_t *prev_sec = NULL;
 
 	// Parse and free all ini sections.
@@ -198,6 +445,17 @@ void ini_free(link_t *src)
 	{
 		ini_kv_t *prev_kv  = NULL;
 
+		// Sections from a cache snapshot are freed all at once.
+		if (ini_sec->arena)
+		{
+			if (ini_sec->arena != arena)
+			{
+				free(arena);
+				arena = ini_sec->arena;
+			}
+			continue;
+		}
+
 		// Free all ini key allocations if they exist.
 		LIST_FOREACH_ENTRY(ini_kv_t, kv, &ini_sec->kvs, link)
 		{
@@ -224,4 +482,7 @@ void ini_free(link_t *src)
 	// Free last section.
 	if (prev_sec)
 		free(prev_sec);
+
+	// Free cache snapshot.
+	free(arena);
 }
@@ -27,6 +27,11 @@
 #define INI_NEWLINE 0xFE
 #define INI_COMMENT 0xFF
 
+#define INI_CACHE_MAGIC   0x43494E49 // "INIC".
+#define INI_CACHE_VERSION 3
+#define INI_CACHE_IPL     "bootloader/sys/cache_ipl.bin"
+#define INI_CACHE_INI_DIR "bootloader/sys/cache_ini.bin"
+
 typedef struct _ini_kv_t
 {
 	char *key;
@@ -41,9 +46,22 @@ typedef struct _ini_sec_t
 	link_t link;
 	u32 type;
 	u32 color;
+	void *arena; // Cache snapshot buffer if not allocated separately.
 } ini_sec_t;
 
+typedef struct _ini_cache_hdr_t
+{
+	u32 magic;
+	u32 version;
+	u32 size;
+	u32 src_crc32; // Names, sizes and modified times of the source files.
+	u32 sec_cnt;
+	u32 rsvd;
+} ini_cache_hdr_t;
+
 int   ini_parse(link_t *dst, char *ini_path, bool is_dir);
+int   ini_parse_cached(link_t *dst, char *ini_path, bool is_dir, const char *cache_path);
+void  ini_cache_invalidate(const char *cache_path);
 char *ini_check_special_section(ini_sec_t *cfg);
 void  ini_free(link_t *src);
 
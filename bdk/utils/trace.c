@@ -0,0 +1,143 @@
+/*
+ * Boot profiler for hekate and Nyx
+ *
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include <memory_map.h>
+#include <mem/heap.h>
+#include <soc/timer.h>
+#include <storage/sd.h>
+#include <utils/trace.h>
+
+#ifdef BDK_TRACE_ENABLE
+
+#define TRACE_EVT_MAX ((BOOT_TRACE_SZ - sizeof(trace_hdr_t)) / sizeof(trace_evt_t))
+
+// Lives in reserved DRAM, so it survives chainloading and Nyx.
+static trace_hdr_t *trace = (trace_hdr_t *)BOOT_TRACE_ADDR;
+
+void trace_init(u32 stage)
+{
+	u32 ts = get_tmr_us();
+
+	// Start over if not valid or if timer was reset by a new boot.
+	if (trace->magic != TRACE_MAGIC || ts < trace->last_ts)
+	{
+		trace->magic = TRACE_MAGIC;
+		trace->count = 0;
+	}
+
+	trace->stage   = stage;
+	trace->last_ts = ts;
+}
+
+void trace_event(const char *name, u32 type)
+{
+	if (trace->magic != TRACE_MAGIC)
+		return;
+
+	trace_evt_t *evt = &trace->evts[trace->count % TRACE_EVT_MAX];
+
+	evt->ts    = get_tmr_us();
+	evt->type  = type;
+	evt->stage = trace->stage;
+	strncpy(evt->name, name, TRACE_NAME_LEN - 1);
+	evt->name[TRACE_NAME_LEN - 1] = 0;
+
+	trace->last_ts = evt->ts;
+	trace->count++;
+}
+
+static char *_trace_add_num(char *dst, const char *key, u32 val)
+{
+	strcpy(dst, key);
+	dst += strlen(dst);
+	itoa(val, dst, 10);
+
+	return dst + strlen(dst);
+}
+
+int trace_export(const char *path)
+{
+	static const char * const stage_names[] = { "hekate", "Nyx" };
+	static const char ph[] = { 'B', 'E', 'i' };
+
+	if (trace->magic != TRACE_MAGIC)
+		return 1;
+
+	u32 count = MIN(trace->count, TRACE_EVT_MAX);
+	u32 start = trace->count - count;
+
+	// Chrome trace event format (JSON). Each event needs less than 128 bytes.
+	char *buf = (char *)malloc((count + ARRAY_SIZE(stage_names) + 2) * 128);
+	char *pos = buf;
+
+	strcpy(pos, "{\"traceEvents\":[\n");
+	pos += strlen(pos);
+
+	for (u32 i = start; i < trace->count; i++)
+	{
+		trace_evt_t *evt = &trace->evts[i % TRACE_EVT_MAX];
+
+		strcpy(pos, "{\"name\":\"");
+		strcat(pos, evt->name);
+		strcat(pos, "\",\"ph\":\"");
+		pos += strlen(pos);
+		*pos++ = ph[evt->type % sizeof(ph)];
+		*pos++ = '"';
+		if (evt->type == TRACE_EVT_MARK)
+		{
+			strcpy(pos, ",\"s\":\"g\"");
+			pos += strlen(pos);
+		}
+		pos = _trace_add_num(pos, ",\"ts\":", evt->ts);
+		pos = _trace_add_num(pos, ",\"pid\":1,\"tid\":", evt->stage);
+		strcpy(pos, "},\n");
+		pos += strlen(pos);
+	}
+
+	// Name threads after stages.
+	for (u32 i = 0; i < ARRAY_SIZE(stage_names); i++)
+	{
+		pos = _trace_add_num(pos, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":", i);
+		strcpy(pos, ",\"args\":{\"name\":\"");
+		strcat(pos, stage_names[i]);
+		strcat(pos, (i + 1) < ARRAY_SIZE(stage_names) ? "\"}},\n" : "\"}}\n");
+		pos += strlen(pos);
+	}
+
+	strcpy(pos, "],\"displayTimeUnit\":\"ms\"}\n");
+	pos += strlen(pos);
+
+	// Mount SD if needed and restore its state after.
+	int res = 1;
+	bool mounted = sd_get_card_mounted();
+	if (mounted || sd_mount())
+	{
+		res = sd_save_to_file(buf, pos - buf, path);
+		if (!mounted)
+			sd_unmount();
+	}
+
+	free(buf);
+
+	return res;
+}
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Boot profiler for hekate and Nyx
+ *
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <utils/types.h>
+
+#define TRACE_MAGIC 0x43525442 // "BTRC".
+#define TRACE_NAME_LEN 24
+
+typedef enum _trace_stage_t
+{
+	TRACE_STAGE_IPL = 0,
+	TRACE_STAGE_NYX = 1,
+} trace_stage_t;
+
+typedef enum _trace_evt_type_t
+{
+	TRACE_EVT_BEGIN = 0,
+	TRACE_EVT_END   = 1,
+	TRACE_EVT_MARK  = 2,
+} trace_evt_type_t;
+
+typedef struct _trace_evt_t
+{
+	u32  ts;    // Timestamp in us.
+	u8   type;
+	u8   stage;
+	u16  rsvd;
+	char name[TRACE_NAME_LEN];
+} trace_evt_t;
+
+typedef struct _trace_hdr_t
+{
+	u32 magic;
+	u32 stage;
+	u32 count;   // Total events. Ring is indexed with count % TRACE_EVT_MAX.
+	u32 last_ts; // Used to detect a timer reset (new boot).
+	trace_evt_t evts[];
+} trace_hdr_t;
+
+#ifdef BDK_TRACE_ENABLE
+void trace_init(u32 stage);
+void trace_event(const char *name, u32 type);
+int  trace_export(const char *path);
+
+#define TRACE_INIT(stage)  trace_init(stage)
+#define TRACE_BEGIN(name)  trace_event(name, TRACE_EVT_BEGIN)
+#define TRACE_END(name)    trace_event(name, TRACE_EVT_END)
+#define TRACE_MARK(name)   trace_event(name, TRACE_EVT_MARK)
+#define TRACE_EXPORT(path) trace_export(path)
+#else
+#define TRACE_INIT(stage)
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#define TRACE_MARK(name)
+#define TRACE_EXPORT(path)
+#endif
+
+#endif
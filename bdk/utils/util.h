@@ -19,7 +19,9 @@
 #define _UTIL_H_
 
 #include <utils/types.h>
+#include <ianos/ianos.h>
 #include <mem/minerva.h>
+#include <storage/sdmmc.h>
 
 #define CFG_SIZE(array) (sizeof(array) / sizeof(cfg_op_t))
 
@@ -79,6 +81,9 @@ typedef struct _nyx_storage_t
 	nyx_info_t info;
 	mtc_config_t mtc_cfg;
 	emc_table_t mtc_table[11]; // 10 + 1.
+	ianos_cache_t ianos_cache;
+	sdmmc_tuning_cache_t sdmmc_tuning;
+	sdmmc_tuning_drop_t  sdmmc_tuning_drop;
 } nyx_storage_t;
 
 u8   bit_count(u32 val);
@@ -39,6 +39,7 @@ typedef struct _hekate_config
 	bool rcm_patched;
 	u32  errors;
 	hos_eks_mbr_t *eks;
+	hos_kcache_mbr_t *kcache;
 } hekate_config;
 
 void set_default_configuration();
@@ -215,6 +215,7 @@ void print_sdcard_info()
 			sd_storage.cid.month, sd_storage.cid.year);
 
 		u16 *sd_errors = sd_get_error_count();
+		u16 *sd_mode_errors = sd_get_mode_error_count();
 		gfx_printf("%kDatos Especificos SD V%d.0:%k\n", TXT_CLR_CYAN_L, sd_storage.csd.structure + 1, TXT_CLR_DEFAULT);
 		gfx_printf(
 			" Clases de Cmd:  %02X\n"
@@ -226,12 +227,19 @@ void print_sdcard_info()
 			" Clase de Video: V%d\n"
 			" Rendim. en App: A%d\n"
 			" Prot. cont. Esc:%d\n"
-			" Errores SDMMC:  %d %d %d\n\n",
+			" Errores SDMMC:  %d %d %d\n"
+			" Errores x Modo: %d %d %d %d",
 			sd_storage.csd.cmdclass, sd_storage.sec_cnt >> 11,
 			sd_storage.ssr.bus_width, sd_storage.csd.busspeed, sd_storage.csd.busspeed * 2,
 			sd_storage.ssr.speed_class, sd_storage.ssr.uhs_grade, sd_storage.ssr.video_class,
 			sd_storage.ssr.app_class, sd_storage.csd.write_protect,
-			sd_errors[0], sd_errors[1], sd_errors[2]); // SD_ERROR_INIT_FAIL, SD_ERROR_RW_FAIL, SD_ERROR_RW_RETRY.
+			sd_errors[0], sd_errors[1], sd_errors[2], // SD_ERROR_INIT_FAIL, SD_ERROR_RW_FAIL, SD_ERROR_RW_RETRY.
+			sd_mode_errors[SD_1BIT_HS25], sd_mode_errors[SD_4BIT_HS25], sd_mode_errors[SD_UHS_SDR82],
+			sd_mode_errors[SD_UHS_SDR104]);
+#ifdef BDK_SDMMC_UHS_DDR200_SUPPORT
+		gfx_printf(" %d", sd_mode_errors[SD_UHS_DDR208]);
+#endif
+		gfx_puts("\n\n");
 
 		int res = f_mount(&sd_fs, "", 1);
 		if (!res)
@@ -68,6 +68,7 @@ void _toggle_autorcm(bool enable)
 			tempbuf[0x10] = corr_mod0;
 		sdmmc_storage_write(&emmc_storage, sect, 1, tempbuf);
 	}
+	emmc_cache_reset();
 
 	free(tempbuf);
 	emmc_end();
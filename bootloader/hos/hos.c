@@ -296,12 +296,147 @@ out:
 	}
 }
 
+static bool _hos_keys_cached = false;
+
+static void _hos_kcache_get()
+{
+	// Check if key cache already found and parsed.
+	if (!h_cfg.kcache)
+	{
+		// Read key cache blob.
+		u8 *mbr = calloc(512 , 1);
+		if (!hos_eks_rw_try(mbr, false))
+			goto out;
+
+		// Decrypt key cache blob.
+		hos_kcache_mbr_t *kcache = (hos_kcache_mbr_t *)(mbr + HOS_KCACHE_MBR_OFF);
+		se_aes_crypt_ecb(14, DECRYPT, kcache, sizeof(hos_kcache_mbr_t), kcache, sizeof(hos_kcache_mbr_t));
+
+		// Check if valid and for this unit.
+		if (kcache->magic == HOS_KCACHE_MAGIC && kcache->lot0 == FUSE(FUSE_OPT_LOT_CODE_0))
+		{
+			h_cfg.kcache = kcache;
+			return;
+		}
+
+out:
+		free(mbr);
+	}
+}
+
+static void _hos_kcache_write()
+{
+	// Read MBR.
+	u8 *mbr = calloc(512 , 1);
+	if (!hos_eks_rw_try(mbr, false))
+		goto out;
+
+	// Encrypt key cache blob.
+	hos_kcache_mbr_t *kcache = (hos_kcache_mbr_t *)(mbr + HOS_KCACHE_MBR_OFF);
+	memcpy(kcache, h_cfg.kcache, sizeof(hos_kcache_mbr_t));
+	se_aes_crypt_ecb(14, ENCRYPT, kcache, sizeof(hos_kcache_mbr_t), kcache, sizeof(hos_kcache_mbr_t));
+
+	// Write key cache blob to SD.
+	hos_eks_rw_try(mbr, true);
+
+out:
+	free(mbr);
+}
+
+static u32 _hos_kcache_mask(u32 kb)
+{
+	return (kb == KB_FIRMWARE_VERSION_620) ? HOS_KCACHE_TSEC_620 : HOS_KCACHE_TSEC_OLD;
+}
+
+static bool _hos_kcache_load(u32 kb, tsec_keys_t *tsec_keys)
+{
+	_hos_kcache_get();
+
+	if (!h_cfg.kcache || !(h_cfg.kcache->enabled & _hos_kcache_mask(kb)))
+		return false;
+
+	if (kb == KB_FIRMWARE_VERSION_620)
+	{
+		memcpy(tsec_keys->tsec,      h_cfg.kcache->tsec_620,  SE_KEY_128_SIZE);
+		memcpy(tsec_keys->tsec_root, h_cfg.kcache->troot_620, SE_KEY_128_SIZE);
+	}
+	else
+		memcpy(tsec_keys->tsec, h_cfg.kcache->tsec, SE_KEY_128_SIZE);
+
+	return true;
+}
+
+static void _hos_kcache_save(u32 kb, tsec_keys_t *tsec_keys)
+{
+	if (!h_cfg.kcache)
+		h_cfg.kcache = calloc(sizeof(hos_kcache_mbr_t), 1);
+
+	// Set magic and personalized info.
+	h_cfg.kcache->magic = HOS_KCACHE_MAGIC;
+	h_cfg.kcache->lot0 = FUSE(FUSE_OPT_LOT_CODE_0);
+	h_cfg.kcache->enabled |= BIT(kb);
+
+	// Copy new keys.
+	if (kb == KB_FIRMWARE_VERSION_620)
+	{
+		memcpy(h_cfg.kcache->tsec_620,  tsec_keys->tsec,      SE_KEY_128_SIZE);
+		memcpy(h_cfg.kcache->troot_620, tsec_keys->tsec_root, SE_KEY_128_SIZE);
+	}
+	else
+		memcpy(h_cfg.kcache->tsec, tsec_keys->tsec, SE_KEY_128_SIZE);
+
+	_hos_kcache_write();
+}
+
+static bool _hos_keyblob_verify(kb_t *kb_data, u32 ks)
+{
+	u8 subkey[SE_KEY_128_SIZE] = {0};
+	u8 cmac[SE_KEY_128_SIZE] = {0};
+	const u8 *data = kb_data->ctr;
+	const u32 size = sizeof(kb_data->ctr) + sizeof(kb_keys_t);
+
+	// Generate AES-CMAC K1 subkey. Keyblob data is block aligned so K2 is not needed.
+	se_aes_crypt_block_ecb(ks, ENCRYPT, subkey, subkey);
+	u8 carry = subkey[0] & 0x80;
+	for (u32 i = 0; i < SE_KEY_128_SIZE - 1; i++)
+		subkey[i] = (subkey[i] << 1) | (subkey[i + 1] >> 7);
+	subkey[SE_KEY_128_SIZE - 1] = (subkey[SE_KEY_128_SIZE - 1] << 1) ^ (carry ? 0x87 : 0);
+
+	// Calculate CBC-MAC and mix K1 into the last block.
+	for (u32 off = 0; off < size; off += SE_KEY_128_SIZE)
+	{
+		for (u32 i = 0; i < SE_KEY_128_SIZE; i++)
+			cmac[i] ^= data[off + i];
+
+		if (off + SE_KEY_128_SIZE == size)
+			for (u32 i = 0; i < SE_KEY_128_SIZE; i++)
+				cmac[i] ^= subkey[i];
+
+		se_aes_crypt_block_ecb(ks, ENCRYPT, cmac, cmac);
+	}
+
+	return !memcmp(kb_data->cmac, cmac, SE_KEY_128_SIZE);
+}
+
 void hos_eks_clear(u32 kb)
 {
 	// Check if Erista based unit.
 	if (h_cfg.t210b01)
 		return;
 
+	// Invalidate cached TSEC keys for old firmware.
+	if (kb <= KB_FIRMWARE_VERSION_620)
+	{
+		_hos_kcache_get();
+		if (h_cfg.kcache && (h_cfg.kcache->enabled & _hos_kcache_mask(kb)))
+		{
+			h_cfg.kcache->enabled &= ~_hos_kcache_mask(kb);
+			_hos_kcache_write();
+		}
+
+		return;
+	}
+
 	if (h_cfg.eks && kb >= KB_FIRMWARE_VERSION_700)
 	{
 		// Check if current Master key is enabled.
@@ -375,8 +510,10 @@ int hos_keygen(void *keyblob, u32 kb, tsec_ctxt_t *tsec_ctxt, bool stock, bool i
 	// Use HOS EKS if it exists.
 	_hos_eks_get();
 
-	// Use tsec keygen for old firmware or if EKS keys does not exist for newer.
-	if (kb <= KB_FIRMWARE_VERSION_620 || !h_cfg.eks || (h_cfg.eks && h_cfg.eks->enabled != HOS_EKS_TSEC_VER))
+	// Use tsec keygen for old firmware if keys are not cached or if EKS keys does not exist for newer.
+	if (kb <= KB_FIRMWARE_VERSION_620)
+		use_tsec = !_hos_kcache_load(kb, &tsec_keys);
+	else if (!h_cfg.eks || (h_cfg.eks && h_cfg.eks->enabled != HOS_EKS_TSEC_VER))
 		use_tsec = true;
 
 	if (kb <= KB_FIRMWARE_VERSION_600)
@@ -420,6 +557,7 @@ int hos_keygen(void *keyblob, u32 kb, tsec_ctxt_t *tsec_ctxt, bool stock, bool i
 		se_aes_key_set(11, h_cfg.eks->troot_dev, SE_KEY_128_SIZE);
 	}
 
+get_tsec_key:
 	// Get TSEC key.
 	while (use_tsec && tsec_query(&tsec_keys, tsec_ctxt) < 0)
 	{
@@ -433,6 +571,7 @@ int hos_keygen(void *keyblob, u32 kb, tsec_ctxt_t *tsec_ctxt, bool stock, bool i
 			return 0;
 		}
 	}
+	_hos_keys_cached = !use_tsec;
 
 	if (kb >= KB_FIRMWARE_VERSION_700)
 	{
@@ -477,6 +616,10 @@ int hos_keygen(void *keyblob, u32 kb, tsec_ctxt_t *tsec_ctxt, bool stock, bool i
 	}
 	else if (kb == KB_FIRMWARE_VERSION_620)
 	{
+		// Cache TSEC keys. Invalidated if pkg2 decryption fails.
+		if (use_tsec)
+			_hos_kcache_save(kb, &tsec_keys);
+
 		// Set TSEC key.
 		se_aes_key_set(12, tsec_keys.tsec, SE_KEY_128_SIZE);
 		// Set TSEC root key.
@@ -520,25 +663,29 @@ int hos_keygen(void *keyblob, u32 kb, tsec_ctxt_t *tsec_ctxt, bool stock, bool i
 		se_aes_key_set(13, tsec_keys.tsec, SE_KEY_128_SIZE);
 
 		// Derive keyblob keys from TSEC+SBK.
-		se_aes_crypt_block_ecb(13, DECRYPT, tsec_keys.tsec, keyblob_keyseeds[0]);
-		se_aes_unwrap_key(15, 14, tsec_keys.tsec);
-		se_aes_crypt_block_ecb(13, DECRYPT, tsec_keys.tsec, keyblob_keyseeds[kb]);
-		se_aes_unwrap_key(13, 14, tsec_keys.tsec);
+		se_aes_crypt_block_ecb(13, DECRYPT, tsec_keys.tmp, keyblob_keyseeds[0]);
+		se_aes_unwrap_key(15, 14, tsec_keys.tmp);
+		se_aes_crypt_block_ecb(13, DECRYPT, tsec_keys.tmp, keyblob_keyseeds[kb]);
+		se_aes_unwrap_key(13, 14, tsec_keys.tmp);
 
 		// Clear SBK.
 		//se_aes_key_clear(14);
 
-/*
 		// Verify keyblob CMAC.
-		u8 cmac[SE_KEY_128_SIZE];
-		se_aes_unwrap_key(11, 13, cmac_keyseed);
-		se_aes_cmac(cmac, SE_KEY_128_SIZE, 11, (void *)kb_data->ctr, sizeof(kb_data->ctr) + sizeof(kb_data->keys));
-		if (!memcmp(kb_data->cmac, cmac, SE_KEY_128_SIZE))
-			return 0;
-*/
-
-		se_aes_crypt_block_ecb(13, DECRYPT, tsec_keys.tsec, cmac_keyseed);
 		se_aes_unwrap_key(11, 13, cmac_keyseed);
+		if (_hos_keyblob_verify(kb_data, 11))
+		{
+			// Cache TSEC key now that it's verified.
+			if (use_tsec)
+				_hos_kcache_save(kb, &tsec_keys);
+		}
+		else if (!use_tsec)
+		{
+			// Cached TSEC key is stale. Invalidate it and get a new one.
+			hos_eks_clear(kb);
+			use_tsec = true;
+			goto get_tsec_key;
+		}
 
 		// Decrypt keyblob and set keyslots.
 		se_aes_crypt_ctr(13, &kb_data->keys, sizeof(kb_keys_t), &kb_data->keys, sizeof(kb_keys_t), kb_data->ctr);
@@ -704,7 +851,6 @@ static void _free_launch_components(launch_ctxt_t *ctxt)
 static bool _get_fs_exfat_compatible(link_t *info, u32 *hos_revision)
 {
 	u32 fs_ids_cnt;
-	u32 sha_buf[32 / sizeof(u32)];
 	kip1_id_t *kip_ids;
 
 	LIST_FOREACH_ENTRY(pkg2_kip1_info_t, ki, info, link)
@@ -712,14 +858,16 @@ static bool _get_fs_exfat_compatible(link_t *info, u32 *hos_revision)
 		if (strncmp((const char*)ki->kip1->name, "FS", sizeof(ki->kip1->name)))
 			continue;
 
-		if (!se_calc_sha256_oneshot(sha_buf, ki->kip1, ki->size))
+		// Hash is kept and reused when patching kips.
+		const u8 *kip_hash = pkg2_kip_hash(ki);
+		if (!kip_hash)
 			break;
 
 		pkg2_get_ids(&kip_ids, &fs_ids_cnt);
 
 		for (int fs_idx = fs_ids_cnt - 1; fs_idx >= 0; fs_idx--)
 		{
-			if (!memcmp(sha_buf, kip_ids[fs_idx].hash, 8))
+			if (!memcmp(kip_hash, kip_ids[fs_idx].hash, 8))
 			{
 				// HOS Api special handling.
 				if ((fs_idx & ~1) == 16)      // Check if it's 5.1.0.
@@ -753,6 +901,8 @@ int hos_launch(ini_sec_t *cfg)
 	tsec_ctxt_t tsec_ctxt = {0};
 	volatile secmon_mailbox_t *secmon_mailbox;
 
+	TRACE_BEGIN("hos_launch");
+
 	minerva_change_freq(FREQ_1600);
 	list_init(&ctxt.kip1_list);
 
@@ -857,9 +1007,14 @@ int hos_launch(ini_sec_t *cfg)
 	tsec_ctxt.pkg11_off = ctxt.pkg1_id->pkg11_off;
 	tsec_ctxt.secmon_base = secmon_base;
 
-	if (!hos_keygen(ctxt.keyblob, kb, &tsec_ctxt, ctxt.stock, is_exo))
+	TRACE_BEGIN("hos_keygen");
+	u32 keygen_time = get_tmr_us();
+	bool keygen_done = hos_keygen(ctxt.keyblob, kb, &tsec_ctxt, ctxt.stock, is_exo);
+	keygen_time = get_tmr_us() - keygen_time;
+	TRACE_END("hos_keygen");
+	if (!keygen_done)
 		goto error;
-	gfx_puts("Keys Generadas\n");
+	gfx_printf("Keys Generadas en %d us%s\n", keygen_time, _hos_keys_cached ? " (cache)" : "");
 
 	// Decrypt and unpack package1 if we require parts of it.
 	if (!ctxt.warmboot || !ctxt.secmon)
@@ -1042,7 +1197,9 @@ int hos_launch(ini_sec_t *cfg)
 	// Patch kip1s in memory if needed.
 	if (ctxt.kip1_patches)
 		gfx_printf("%kParcheando kips%k\n", TXT_CLR_ORANGE, TXT_CLR_DEFAULT);
+	TRACE_BEGIN("pkg2_patch_kips");
 	const char* unappliedPatch = pkg2_patch_kips(&kip1_info, ctxt.kip1_patches);
+	TRACE_END("pkg2_patch_kips");
 	if (unappliedPatch != NULL)
 	{
 		EHPRINTFARGS("Error al aplicar '%s'!", unappliedPatch);
@@ -1068,6 +1225,10 @@ int hos_launch(ini_sec_t *cfg)
 	if (is_exo)
 		config_exosphere(&ctxt, warmboot_base);
 
+	// Save boot trace.
+	TRACE_END("hos_launch");
+	TRACE_EXPORT("bootloader/trace.json");
+
 	// Unmount SD card and eMMC.
 	sd_end();
 	emmc_end();
@@ -75,6 +75,25 @@ typedef struct _hos_eks_mbr_t
 
 static_assert(sizeof(hos_eks_mbr_t) == 64, "Tam. de HOS EKS equivocado!");
 
+#define HOS_KCACHE_MAGIC    0x3143534B // "KSC1".
+#define HOS_KCACHE_MBR_OFF  0xC0
+#define HOS_KCACHE_TSEC_OLD (BIT(KB_FIRMWARE_VERSION_620) - 1)
+#define HOS_KCACHE_TSEC_620 BIT(KB_FIRMWARE_VERSION_620)
+
+// TSEC derived keys for pre 7.0.0 firmware. Stored in MBR after EKS.
+typedef struct _hos_kcache_mbr_t
+{
+	u32 magic;
+	u32 enabled; // Bitmask of verified keyblob versions.
+	u32 lot0;
+	u32 rsvd;
+	u8  tsec[SE_KEY_128_SIZE];      // 1.0.0 - 6.0.1.
+	u8  tsec_620[SE_KEY_128_SIZE];  // 6.2.0.
+	u8  troot_620[SE_KEY_128_SIZE]; // 6.2.0.
+} hos_kcache_mbr_t;
+
+static_assert(sizeof(hos_kcache_mbr_t) == 64, "Tam. de HOS KCACHE equivocado!");
+
 typedef struct _launch_ctxt_t
 {
 	void *keyblob;
@@ -449,7 +449,7 @@ void pkg1_warmboot_rsa_mod(u32 warmboot_base)
 	for (u32 i = 0; i < 4; i++)
 	{
 		sector = 1 + (32 * i); // 0x4000 bct + 0x200 offset.
-		sdmmc_storage_read(&emmc_storage, sector, 1, rsa_mod);
+		emmc_read_cached(sector, 1, rsa_mod);
 
 		// Check if 2nd byte of modulus is correct.
 		if (rsa_mod[0x11] != mod1)
@@ -66,6 +66,148 @@ void pkg2_get_ids(kip1_id_t **ids, u32 *entries)
 	*entries = _kip_id_sets_cnt;
 }
 
+#define KIP1_NAME_LEN 12
+
+typedef struct _kip1_name_idx_t
+{
+	const char *name;
+	u16 start;      // First entry in kip id order table.
+	u16 cnt;        // Number of kip ids with that name.
+	u32 patch_mask; // Requested patches that exist in any of its patchsets.
+} kip1_name_idx_t;
+
+static kip1_name_idx_t *_kip_name_idx = NULL;
+static u32 _kip_name_idx_cnt = 0;
+static u16 *_kip_id_order = NULL; // Kip ids grouped by name.
+static u32 *_kip_id_masks = NULL; // Requested patches per kip id.
+
+static void _pkg2_kip_index_free()
+{
+	free(_kip_name_idx);
+	free(_kip_id_order);
+	free(_kip_id_masks);
+	_kip_name_idx = NULL;
+	_kip_id_order = NULL;
+	_kip_id_masks = NULL;
+	_kip_name_idx_cnt = 0;
+}
+
+static void _pkg2_kip_index_build()
+{
+	if (_kip_name_idx)
+		return;
+
+	_kip_name_idx = (kip1_name_idx_t *)calloc(sizeof(kip1_name_idx_t), _kip_id_sets_cnt);
+	_kip_id_order = (u16 *)malloc(sizeof(u16) * _kip_id_sets_cnt);
+	_kip_id_masks = (u32 *)calloc(sizeof(u32), _kip_id_sets_cnt);
+	u8 *id_name_slot = (u8 *)malloc(_kip_id_sets_cnt);
+
+	// Count kip ids per name.
+	for (u32 i = 0; i < _kip_id_sets_cnt; i++)
+	{
+		u32 slot;
+		for (slot = 0; slot < _kip_name_idx_cnt; slot++)
+			if (!strncmp(_kip_name_idx[slot].name, _kip_id_sets[i].name, KIP1_NAME_LEN))
+				break;
+
+		if (slot == _kip_name_idx_cnt)
+		{
+			_kip_name_idx[slot].name = _kip_id_sets[i].name;
+			_kip_name_idx_cnt++;
+		}
+
+		_kip_name_idx[slot].cnt++;
+		id_name_slot[i] = slot;
+	}
+
+	// Set start offsets and fill order table. Original id order is kept inside each name group.
+	u32 start = 0;
+	for (u32 slot = 0; slot < _kip_name_idx_cnt; slot++)
+	{
+		_kip_name_idx[slot].start = start;
+		start += _kip_name_idx[slot].cnt;
+		_kip_name_idx[slot].cnt = 0;
+	}
+
+	for (u32 i = 0; i < _kip_id_sets_cnt; i++)
+	{
+		kip1_name_idx_t *kip_name = &_kip_name_idx[id_name_slot[i]];
+		_kip_id_order[kip_name->start + kip_name->cnt] = i;
+		kip_name->cnt++;
+	}
+
+	free(id_name_slot);
+}
+
+static kip1_name_idx_t *_pkg2_kip_index_find(const char *name)
+{
+	for (u32 slot = 0; slot < _kip_name_idx_cnt; slot++)
+		if (!strncmp(_kip_name_idx[slot].name, name, KIP1_NAME_LEN))
+			return &_kip_name_idx[slot];
+
+	return NULL;
+}
+
+static u32 _pkg2_patchset_req_mask(const kip1_patchset_t *patchset, char **patches, u32 num_patches)
+{
+	u32 mask = 0;
+	for (u32 i = 0; i < num_patches; i++)
+		if (!strcmp(patchset->name, patches[i]))
+			mask |= BIT(i);
+
+	return mask;
+}
+
+static void _pkg2_kip_index_resolve(char **patches, u32 num_patches)
+{
+	u32 mask = 0;
+	kip1_patchset_t *prev_patchset = NULL;
+
+	for (u32 slot = 0; slot < _kip_name_idx_cnt; slot++)
+		_kip_name_idx[slot].patch_mask = 0;
+
+	for (u32 i = 0; i < _kip_id_sets_cnt; i++)
+	{
+		// Kip ids of the same version share patchsets. Resolve them only once.
+		kip1_patchset_t *patchset = _kip_id_sets[i].patchset;
+		if (patchset != prev_patchset)
+		{
+			prev_patchset = patchset;
+			mask = 0;
+			while (patchset != NULL && patchset->name != NULL)
+			{
+				mask |= _pkg2_patchset_req_mask(patchset, patches, num_patches);
+				patchset++;
+			}
+		}
+
+		_kip_id_masks[i] = mask;
+	}
+
+	for (u32 slot = 0; slot < _kip_name_idx_cnt; slot++)
+	{
+		kip1_name_idx_t *kip_name = &_kip_name_idx[slot];
+		for (u32 i = kip_name->start; i < kip_name->start + kip_name->cnt; i++)
+			kip_name->patch_mask |= _kip_id_masks[_kip_id_order[i]];
+	}
+}
+
+const u8 *pkg2_kip_hash(pkg2_kip1_info_t *ki)
+{
+	// Reuse hash if already calculated for this kip.
+	if (ki->hashed)
+		return ki->hash;
+
+	u32 sha_buf[SE_SHA_256_SIZE / sizeof(u32)];
+	if (!se_calc_sha256_oneshot(sha_buf, ki->kip1, ki->size))
+		return NULL;
+
+	memcpy(ki->hash, sha_buf, sizeof(ki->hash));
+	ki->hashed = true;
+
+	return ki->hash;
+}
+
 static void parse_external_kip_patches()
 {
 	static bool ext_patches_parsed = false;
@@ -73,8 +215,51 @@ static void parse_external_kip_patches()
 	if (ext_patches_parsed)
 		return;
 
+	kip1_id_t *ext_ids;
+	u32 ext_ids_cnt;
+
 	LIST_INIT(ini_kip_sections);
-	if (ini_patch_parse(&ini_kip_sections, "bootloader/patches.ini"))
+	if (ini_patch_bundle_load(&ext_ids, &ext_ids_cnt, "bootloader/patches.bin", "bootloader/patches.ini"))
+	{
+		// Copy ids into a new patchset.
+		_kip_id_sets = calloc(sizeof(kip1_id_t), 256); // Max 256 kip ids.
+		memcpy(_kip_id_sets, _kip_ids, sizeof(_kip_ids));
+
+		// Bundle is already parsed and used in place. Only glue patchsets of predefined kips.
+		for (u32 ext_idx = 0; ext_idx < ext_ids_cnt && _kip_id_sets_cnt < 255; ext_idx++)
+		{
+			kip1_id_t *ext_kip = &ext_ids[ext_idx];
+
+			u32 curr_kip_idx;
+			for (curr_kip_idx = 0; curr_kip_idx < ARRAY_SIZE(_kip_ids); curr_kip_idx++)
+				if (!strcmp(_kip_ids[curr_kip_idx].name, ext_kip->name) && !memcmp(_kip_ids[curr_kip_idx].hash, ext_kip->hash, 8))
+					break;
+
+			// If not found, use bundle entry as is.
+			if (curr_kip_idx == ARRAY_SIZE(_kip_ids))
+			{
+				memcpy(&_kip_id_sets[_kip_id_sets_cnt], ext_kip, sizeof(kip1_id_t));
+				_kip_id_sets_cnt++;
+
+				continue;
+			}
+
+			u32 patchsets_cnt = 0;
+			u32 ext_patchsets_cnt = 0;
+			kip1_patchset_t *curr_patchsets = _kip_id_sets[curr_kip_idx].patchset;
+			while (curr_patchsets[patchsets_cnt].name)
+				patchsets_cnt++;
+			while (ext_kip->patchset[ext_patchsets_cnt].name)
+				ext_patchsets_cnt++;
+
+			kip1_patchset_t *patchsets = (kip1_patchset_t *)calloc(sizeof(kip1_patchset_t), patchsets_cnt + ext_patchsets_cnt + 1);
+			memcpy(patchsets, curr_patchsets, sizeof(kip1_patchset_t) * patchsets_cnt);
+			memcpy(&patchsets[patchsets_cnt], ext_kip->patchset, sizeof(kip1_patchset_t) * ext_patchsets_cnt);
+
+			_kip_id_sets[curr_kip_idx].patchset = patchsets;
+		}
+	}
+	else if (ini_patch_parse(&ini_kip_sections, "bootloader/patches.ini"))
 	{
 		// Copy ids into a new patchset.
 		_kip_id_sets = calloc(sizeof(kip1_id_t), 256); // Max 256 kip ids.
@@ -167,6 +352,9 @@ static void parse_external_kip_patches()
 		}
 	}
 
+	// Kip ids changed. Index will be rebuilt on next use.
+	_pkg2_kip_index_free();
+
 	ext_patches_parsed = true;
 }
 
@@ -243,6 +431,7 @@ bool pkg2_parse_kips(link_t *info, pkg2_hdr_t *pkg2, bool *new_pkg2)
 		pkg2_kip1_info_t *ki = (pkg2_kip1_info_t *)malloc(sizeof(pkg2_kip1_info_t));
 		ki->kip1 = kip1;
 		ki->size = _pkg2_calc_kip1_size(kip1);
+		ki->hashed = false;
 		list_append(info, &ki->link);
 		ptr += ki->size;
 DPRINTF(" kip1 %d:%s @ %08X (%08X)\n", i, kip1->name, (u32)kip1, ki->size);
@@ -267,6 +456,7 @@ void pkg2_replace_kip(link_t *info, u64 tid, pkg2_kip1_t *kip1)
 		{
 			ki->kip1 = kip1;
 			ki->size = _pkg2_calc_kip1_size(kip1);
+			ki->hashed = false;
 DPRINTF("reemplazado kip %s (nuevo tam. %08X)\n", kip1->name, ki->size);
 			return;
 		}
@@ -278,6 +468,7 @@ void pkg2_add_kip(link_t *info, pkg2_kip1_t *kip1)
 	pkg2_kip1_info_t *ki = (pkg2_kip1_info_t *)malloc(sizeof(pkg2_kip1_info_t));
 	ki->kip1 = kip1;
 	ki->size = _pkg2_calc_kip1_size(kip1);
+	ki->hashed = false;
 DPRINTF("unido kip %s (tam. %08X)\n", kip1->name, ki->size);
 	list_append(info, &ki->link);
 }
@@ -356,6 +547,7 @@ int pkg2_decompress_kip(pkg2_kip1_info_t* ki, u32 sectsToDecomp)
 	free(ki->kip1);
 	ki->kip1 = newKip;
 	ki->size = newKipSize;
+	ki->hashed = false;
 
 	return 0;
 }
@@ -378,6 +570,7 @@ static int _kipm_inject(const char *kipm_path, char *target_name, pkg2_kip1_info
 		pkg2_kip1_t *fs_kip = ki->kip1;
 		ki->kip1 = (pkg2_kip1_t *)kip_patched_data;
 		ki->size = ki->size + inject_size;
+		ki->hashed = false;
 
 		// Patch caps.
 		memcpy(&ki->kip1->caps, kipm_data, sizeof(ki->kip1->caps));
@@ -487,62 +680,42 @@ const char* pkg2_patch_kips(link_t *info, char* patchNames)
 		}
 	}
 
-	u32 shaBuf[SE_SHA_256_SIZE / sizeof(u32)];
+	// Resolve requested patch names to a bitmask per kip id, once.
+	_pkg2_kip_index_build();
+	_pkg2_kip_index_resolve(patches, numPatches);
+
 	LIST_FOREACH_ENTRY(pkg2_kip1_info_t, ki, info, link)
 	{
-		shaBuf[0] = 0; // sha256 for this kip not yet calculated.
-		for (u32 currKipIdx = 0; currKipIdx < _kip_id_sets_cnt; currKipIdx++)
-		{
-			if (strncmp((const char*)ki->kip1->name, _kip_id_sets[currKipIdx].name, sizeof(ki->kip1->name)) != 0)
-				continue;
-
-			u32 bitsAffected = 0;
-			kip1_patchset_t* currPatchset = _kip_id_sets[currKipIdx].patchset;
-			while (currPatchset != NULL && currPatchset->name != NULL)
-			{
-				for (u32 i = 0; i < numPatches; i++)
-				{
-					// Continue if patch name does not match.
-					if (strcmp(currPatchset->name, patches[i]) != 0)
-						continue;
+		// Dont bother even hashing this KIP if we dont have any patches enabled for it.
+		kip1_name_idx_t *kip_name = _pkg2_kip_index_find((const char *)ki->kip1->name);
+		if (!kip_name || !kip_name->patch_mask)
+			continue;
 
-					bitsAffected = i + 1;
-					break;
-				}
-				currPatchset++;
-			}
+		const u8 *kip_hash = pkg2_kip_hash(ki);
+		if (!kip_hash)
+			continue;
 
-			// Dont bother even hashing this KIP if we dont have any patches enabled for it.
-			if (bitsAffected == 0)
+		for (u32 order_idx = kip_name->start; order_idx < kip_name->start + kip_name->cnt; order_idx++)
+		{
+			u32 currKipIdx = _kip_id_order[order_idx];
+			if (!_kip_id_masks[currKipIdx])
 				continue;
 
-			if (shaBuf[0] == 0)
-			{
-				if (!se_calc_sha256_oneshot(shaBuf, ki->kip1, ki->size))
-					memset(shaBuf, 0, sizeof(shaBuf));
-			}
-
-			if (memcmp(shaBuf, _kip_id_sets[currKipIdx].hash, sizeof(_kip_id_sets[0].hash)) != 0)
+			if (memcmp(kip_hash, _kip_id_sets[currKipIdx].hash, sizeof(_kip_id_sets[0].hash)) != 0)
 				continue;
 
 			// Find out which sections are affected by the enabled patches, to know which to decompress.
-			bitsAffected = 0;
-			currPatchset = _kip_id_sets[currKipIdx].patchset;
+			u32 bitsAffected = 0;
+			kip1_patchset_t *currPatchset = _kip_id_sets[currKipIdx].patchset;
 			while (currPatchset != NULL && currPatchset->name != NULL)
 			{
-				if (currPatchset->patches != NULL)
+				if (currPatchset->patches != NULL && _pkg2_patchset_req_mask(currPatchset, patches, numPatches))
 				{
-					for (u32 currEnabIdx = 0; currEnabIdx < numPatches; currEnabIdx++)
-					{
-						if (strcmp(currPatchset->name, patches[currEnabIdx]))
-							continue;
-
-						if (!strcmp(currPatchset->name, "emummc"))
-							bitsAffected |= BIT(GET_KIP_PATCH_SECTION(currPatchset->patches->offset));
+					if (!strcmp(currPatchset->name, "emummc"))
+						bitsAffected |= BIT(GET_KIP_PATCH_SECTION(currPatchset->patches->offset));
 
-						for (const kip1_patch_t* currPatch=currPatchset->patches; currPatch != NULL && (currPatch->length != 0); currPatch++)
-							bitsAffected |= BIT(GET_KIP_PATCH_SECTION(currPatch->offset));
-					}
+					for (const kip1_patch_t* currPatch=currPatchset->patches; currPatch != NULL && (currPatch->length != 0); currPatch++)
+						bitsAffected |= BIT(GET_KIP_PATCH_SECTION(currPatch->offset));
 				}
 				currPatchset++;
 			}
@@ -555,69 +728,69 @@ const char* pkg2_patch_kips(link_t *info, char* patchNames)
 			bool emummc_patch_selected = false;
 			while (currPatchset != NULL && currPatchset->name != NULL)
 			{
-				for (u32 currEnabIdx = 0; currEnabIdx < numPatches; currEnabIdx++)
+				u32 appliedMask = _pkg2_patchset_req_mask(currPatchset, patches, numPatches);
+				if (!appliedMask)
 				{
-					if (strcmp(currPatchset->name, patches[currEnabIdx]))
-						continue;
-
-					u32 appliedMask = BIT(currEnabIdx);
+					currPatchset++;
+					continue;
+				}
 
-					if (!strcmp(currPatchset->name, "emummc"))
-					{
-						emummc_patch_selected = true;
-						patchesApplied |= appliedMask;
+				if (!strcmp(currPatchset->name, "emummc"))
+				{
+					emummc_patch_selected = true;
+					patchesApplied |= appliedMask;
 
-						continue; // Patching is done later.
-					}
+					currPatchset++;
+					continue; // Patching is done later.
+				}
 
-					if (currPatchset->patches == NULL)
-					{
-						DPRINTF("Parche '%s' no necesario para %s\n", currPatchset->name, (const char*)ki->kip1->name);
-						patchesApplied |= appliedMask;
+				if (currPatchset->patches == NULL)
+				{
+					DPRINTF("Parche '%s' no necesario para %s\n", currPatchset->name, (const char*)ki->kip1->name);
+					patchesApplied |= appliedMask;
 
-						continue; // Continue in case it's double defined.
-					}
+					currPatchset++;
+					continue; // Continue in case it's double defined.
+				}
 
-					unsigned char* kipSectData = ki->kip1->data;
-					for (u32 currSectIdx = 0; currSectIdx < KIP1_NUM_SECTIONS; currSectIdx++)
+				unsigned char* kipSectData = ki->kip1->data;
+				for (u32 currSectIdx = 0; currSectIdx < KIP1_NUM_SECTIONS; currSectIdx++)
+				{
+					if (bitsAffected & BIT(currSectIdx))
 					{
-						if (bitsAffected & BIT(currSectIdx))
+						gfx_printf("Aplicando '%s' en %s, sect %d\n", currPatchset->name, (const char*)ki->kip1->name, currSectIdx);
+						for (const kip1_patch_t* currPatch = currPatchset->patches; currPatch != NULL && currPatch->srcData != NULL; currPatch++)
 						{
-							gfx_printf("Aplicando '%s' en %s, sect %d\n", currPatchset->name, (const char*)ki->kip1->name, currSectIdx);
-							for (const kip1_patch_t* currPatch = currPatchset->patches; currPatch != NULL && currPatch->srcData != NULL; currPatch++)
+							if (GET_KIP_PATCH_SECTION(currPatch->offset) != currSectIdx)
+								continue;
+
+							if (!currPatch->length)
 							{
-								if (GET_KIP_PATCH_SECTION(currPatch->offset) != currSectIdx)
-									continue;
-
-								if (!currPatch->length)
-								{
-									gfx_con.mute = false;
-									gfx_printf("%kParche vacio!%k\n", TXT_CLR_ERROR, TXT_CLR_DEFAULT);
-									return currPatchset->name; // MUST stop here as it's not probably intended.
-								}
-
-								u32 currOffset = GET_KIP_PATCH_OFFSET(currPatch->offset);
-								// If source does not match and is not already patched, throw an error.
-								if ((memcmp(&kipSectData[currOffset], currPatch->srcData, currPatch->length) != 0) &&
-									(memcmp(&kipSectData[currOffset], currPatch->dstData, currPatch->length) != 0))
-								{
-									gfx_con.mute = false;
-									gfx_printf("%kDesajuste de parche en 0x%x!%k\n", TXT_CLR_ERROR, currOffset, TXT_CLR_DEFAULT);
-									return currPatchset->name; // MUST stop here as kip is likely corrupt.
-								}
-								else
-								{
-									DPRINTF("Parcheando %d bytes en offset 0x%x\n", currPatch->length, currOffset);
-									memcpy(&kipSectData[currOffset], currPatch->dstData, currPatch->length);
-								}
+								gfx_con.mute = false;
+								gfx_printf("%kParche vacio!%k\n", TXT_CLR_ERROR, TXT_CLR_DEFAULT);
+								return currPatchset->name; // MUST stop here as it's not probably intended.
+							}
+
+							u32 currOffset = GET_KIP_PATCH_OFFSET(currPatch->offset);
+							// If source does not match and is not already patched, throw an error.
+							if ((memcmp(&kipSectData[currOffset], currPatch->srcData, currPatch->length) != 0) &&
+								(memcmp(&kipSectData[currOffset], currPatch->dstData, currPatch->length) != 0))
+							{
+								gfx_con.mute = false;
+								gfx_printf("%kDesajuste de parche en 0x%x!%k\n", TXT_CLR_ERROR, currOffset, TXT_CLR_DEFAULT);
+								return currPatchset->name; // MUST stop here as kip is likely corrupt.
+							}
+							else
+							{
+								DPRINTF("Parcheando %d bytes en offset 0x%x\n", currPatch->length, currOffset);
+								memcpy(&kipSectData[currOffset], currPatch->dstData, currPatch->length);
 							}
 						}
-						kipSectData += ki->kip1->sections[currSectIdx].size_comp;
 					}
-
-					patchesApplied |= appliedMask;
-					continue; // Continue in case it's double defined.
+					kipSectData += ki->kip1->sections[currSectIdx].size_comp;
 				}
+
+				patchesApplied |= appliedMask;
 				currPatchset++;
 			}
 
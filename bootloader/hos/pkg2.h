@@ -117,6 +117,8 @@ typedef struct _pkg2_kip1_info_t
 {
 	pkg2_kip1_t *kip1;
 	u32 size;
+	bool hashed; // Hash is valid for current kip1 data.
+	u8 hash[8];
 	link_t link;
 } pkg2_kip1_info_t;
 
@@ -154,6 +156,7 @@ void pkg2_replace_kip(link_t *info, u64 tid, pkg2_kip1_t *kip1);
 void pkg2_add_kip(link_t *info, pkg2_kip1_t *kip1);
 void pkg2_merge_kip(link_t *info, pkg2_kip1_t *kip1);
 void pkg2_get_ids(kip1_id_t **ids, u32 *entries);
+const u8 *pkg2_kip_hash(pkg2_kip1_info_t *ki);
 const char* pkg2_patch_kips(link_t *info, char* patchNames);
 
 const pkg2_kernel_id_t *pkg2_identify(u8 *hash);
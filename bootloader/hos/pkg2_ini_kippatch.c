@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022 CTCaer
+ * Copyright (c) 2019-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -178,3 +178,142 @@ int ini_patch_parse(link_t *dst, char *ini_path)
 
 	return 1;
 }
+
+#define KPB_PTR(type, off) ((type)(bundle + (u32)(off)))
+
+static bool _kpb_table_valid(u32 off, u32 cnt, u32 ent_size, u32 size)
+{
+	// Division avoids u32 wrap on corrupt counts.
+	return off >= sizeof(kpb_hdr_t) && off <= size && !(off & 3) && cnt <= (size - off) / ent_size;
+}
+
+static bool _kpb_entry_valid(u32 off, u32 tbl_off, u32 cnt, u32 ent_size)
+{
+	return off >= tbl_off && !((off - tbl_off) % ent_size) && (off - tbl_off) / ent_size < cnt;
+}
+
+static bool _kpb_str_valid(const u8 *bundle, u32 off, u32 size)
+{
+	return off < size && strnlen((const char *)bundle + off, size - off) < size - off;
+}
+
+static bool _kpb_data_valid(u32 off, u32 len, u32 size)
+{
+	return len <= size && off <= size - len;
+}
+
+static bool _kpb_ini_check(kpb_hdr_t *hdr, const char *bundle_path, const char *ini_path)
+{
+	// Source ini is optional.
+	FILINFO fno;
+	if (f_stat(ini_path, &fno) != FR_OK)
+		return true;
+
+	if (fno.fsize != hdr->ini_size)
+		return false;
+
+	// Trust size and modified time once the bundle was matched against this file.
+	u32 ini_time = (fno.fdate << 16) | fno.ftime;
+	if (hdr->ini_time == ini_time)
+		return true;
+
+	// Bundle is new or ini was touched. Check contents once and stamp its time.
+	u32 ini_size = 0;
+	u8 *ini = (u8 *)sd_file_read(ini_path, &ini_size);
+	bool stale = !ini || crc32_calc(0, ini, ini_size) != hdr->ini_crc32;
+	free(ini);
+
+	if (stale)
+		return false;
+
+	FIL fp;
+	hdr->ini_time = ini_time;
+	if (f_open(&fp, bundle_path, FA_WRITE) == FR_OK)
+	{
+		f_write(&fp, hdr, sizeof(kpb_hdr_t), NULL);
+		f_close(&fp);
+	}
+
+	return true;
+}
+
+int ini_patch_bundle_load(kip1_id_t **ids, u32 *ids_cnt, const char *bundle_path, const char *ini_path)
+{
+	u32 size = 0;
+	u8 *bundle = (u8 *)sd_file_read(bundle_path, &size);
+	if (!bundle)
+		return 0;
+
+	kpb_hdr_t *hdr = (kpb_hdr_t *)bundle;
+	if (size < sizeof(kpb_hdr_t) || hdr->magic != KPB_MAGIC || hdr->version != KPB_VERSION || hdr->size != size)
+		goto error;
+
+	// Check table bounds and alignment.
+	if (!_kpb_table_valid(hdr->kips_off,    hdr->kips_cnt,    sizeof(kip1_id_t),       size) ||
+		!_kpb_table_valid(hdr->psets_off,   hdr->psets_cnt,   sizeof(kip1_patchset_t), size) ||
+		!_kpb_table_valid(hdr->patches_off, hdr->patches_cnt, sizeof(kip1_patch_t),    size))
+		goto error;
+
+	kip1_id_t *kips = KPB_PTR(kip1_id_t *, hdr->kips_off);
+	kip1_patchset_t *psets = KPB_PTR(kip1_patchset_t *, hdr->psets_off);
+	kip1_patch_t *patches = KPB_PTR(kip1_patch_t *, hdr->patches_off);
+
+	// Lists are walked until their terminator. Make sure the last entries are ones.
+	if ((hdr->psets_cnt && psets[hdr->psets_cnt - 1].name) ||
+		(hdr->patches_cnt && (patches[hdr->patches_cnt - 1].srcData || patches[hdr->patches_cnt - 1].length)))
+		goto error;
+
+	// Check if bundle is stale.
+	if (!_kpb_ini_check(hdr, bundle_path, ini_path))
+		goto error;
+
+	// Relocate tables in place.
+	for (u32 i = 0; i < hdr->kips_cnt; i++)
+	{
+		if (!_kpb_str_valid(bundle, (u32)kips[i].name, size) ||
+			!_kpb_entry_valid((u32)kips[i].patchset, hdr->psets_off, hdr->psets_cnt, sizeof(kip1_patchset_t)))
+			goto error;
+
+		kips[i].name     = KPB_PTR(const char *, kips[i].name);
+		kips[i].patchset = KPB_PTR(kip1_patchset_t *, kips[i].patchset);
+	}
+
+	for (u32 i = 0; i < hdr->psets_cnt; i++)
+	{
+		// Skip terminators.
+		if (!psets[i].name)
+			continue;
+
+		if (!_kpb_str_valid(bundle, (u32)psets[i].name, size) ||
+			!_kpb_entry_valid((u32)psets[i].patches, hdr->patches_off, hdr->patches_cnt, sizeof(kip1_patch_t)))
+			goto error;
+
+		psets[i].name    = KPB_PTR(char *, psets[i].name);
+		psets[i].patches = KPB_PTR(kip1_patch_t *, psets[i].patches);
+	}
+
+	for (u32 i = 0; i < hdr->patches_cnt; i++)
+	{
+		// Skip terminators.
+		if (!patches[i].srcData)
+			continue;
+
+		if (!_kpb_data_valid((u32)patches[i].srcData, patches[i].length, size) ||
+			!_kpb_data_valid((u32)patches[i].dstData, patches[i].length, size))
+			goto error;
+
+		patches[i].srcData = KPB_PTR(char *, patches[i].srcData);
+		if (patches[i].length) // Empty patches have no destination data.
+			patches[i].dstData = KPB_PTR(char *, patches[i].dstData);
+	}
+
+	*ids = kips;
+	*ids_cnt = hdr->kips_cnt;
+
+	return 1;
+
+error:
+	free(bundle);
+
+	return 0;
+}
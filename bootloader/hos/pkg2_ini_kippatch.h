@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019 CTCaer
+ * Copyright (c) 2019-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -19,6 +19,28 @@
 
 #include <bdk.h>
 
+#include "pkg2.h"
+
+#define KPB_MAGIC   0x3042504B // "KPB0".
+#define KPB_VERSION 2
+
+// Pre-compiled patches.ini. Tables match kip1_id_t, kip1_patchset_t and kip1_patch_t with offsets as pointers.
+typedef struct _kpb_hdr_t
+{
+	u32 magic;
+	u32 version;
+	u32 size;
+	u32 ini_size;    // Source patches.ini size.
+	u32 ini_crc32;   // Source patches.ini crc32.
+	u32 kips_cnt;    // Sorted by name and hash.
+	u32 kips_off;
+	u32 psets_cnt;   // Including null terminators.
+	u32 psets_off;
+	u32 patches_cnt; // Including null terminators.
+	u32 patches_off;
+	u32 ini_time;    // Source patches.ini FAT date << 16 | time. Stamped on first match, 0 if unknown.
+} kpb_hdr_t;
+
 typedef struct _ini_patchset_t
 {
 	char *name;
@@ -38,5 +60,6 @@ typedef struct _ini_kip_sec_t
 } ini_kip_sec_t;
 
 int ini_patch_parse(link_t *dst, char *ini_path);
+int ini_patch_bundle_load(kip1_id_t **ids, u32 *ids_cnt, const char *bundle_path, const char *ini_path);
 
 #endif
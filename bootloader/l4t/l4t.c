@@ -1005,6 +1005,8 @@ void launch_l4t(const ini_sec_t *ini_sec, int entry_idx, int is_list, bool t210b
 	plat_params_from_bl2_t plat_params = {0};
 	entry_point_info_t bl33_ep_info    = {0};
 
+	TRACE_BEGIN("launch_l4t");
+
 	gfx_con_setpos(0, 0);
 
 	// Parse config.
@@ -1094,7 +1096,10 @@ void launch_l4t(const ini_sec_t *ini_sec, int entry_idx, int is_list, bool t210b
 	if (!_l4t_sc7_exit_config(t210b01))
 		return;
 
-	// Done loading bootloaders/firmware.
+	// Done loading bootloaders/firmware. Save boot trace.
+	TRACE_END("launch_l4t");
+	TRACE_EXPORT("bootloader/trace.json");
+	emmc_end_deferred();
 	sd_end();
 
 	// We don't need AHB aperture open.
@@ -243,6 +243,7 @@ static void _launch_payload(char *path, bool update, bool clear_screen)
 	if (update && is_ipl_updated(buf, path, false))
 		goto out;
 
+	emmc_end_deferred();
 	sd_end();
 
 	if (size < 0x30000)
@@ -388,7 +389,7 @@ static void _launch_ini_list()
 		goto parse_failed;
 
 	// Check that ini files exist and parse them.
-	if (!ini_parse(&ini_list_sections, "bootloader/ini", true))
+	if (!ini_parse_cached(&ini_list_sections, "bootloader/ini", true, INI_CACHE_INI_DIR))
 	{
 		EPRINTF("No hay archivos .ini en bootloader/ini!");
 		goto parse_failed;
@@ -517,7 +518,7 @@ static void _launch_config()
 	emummc_load_cfg();
 
 	// Parse main configuration.
-	ini_parse(&ini_sections, "bootloader/hekate_ipl.ini", false);
+	ini_parse_cached(&ini_sections, "bootloader/hekate_ipl.ini", false, INI_CACHE_IPL);
 
 	// Build configuration menu.
 	ment_t *ments = (ment_t *)malloc(sizeof(ment_t) * (max_entries + 6));
@@ -643,14 +644,75 @@ out:
 	btn_wait();
 }
 
+#define SDMMC_TUNING_PATH "bootloader/sys/sdmmc_tune.bin"
+
+static void _sdmmc_tuning_cache_sync()
+{
+	u32 size = 0;
+	bool save = sdmmc_storage_tuning_drop_count() != 0; // Dropped profiles must be removed from SD.
+	sdmmc_tuning_cache_t *cache = (sdmmc_tuning_cache_t *)&nyx_str->sdmmc_tuning;
+	sdmmc_tuning_cache_t *saved = (sdmmc_tuning_cache_t *)sd_file_read(SDMMC_TUNING_PATH, &size);
+
+	if (saved && (size != sizeof(sdmmc_tuning_cache_t) || saved->magic != SDMMC_TUNING_CACHE_MAGIC ||
+		saved->count > SDMMC_TUNING_PROFILES))
+	{
+		free(saved);
+		saved = NULL;
+	}
+
+	// Merge saved profiles. Profiles tuned in this session take precedence. Dropped cards stay out.
+	if (saved)
+	{
+		for (u32 i = 0; i < saved->count; i++)
+		{
+			if (!sdmmc_storage_tuning_dropped(saved->profiles[i].cid))
+				sdmmc_storage_tuning_cache_add(&saved->profiles[i], false);
+		}
+	}
+
+	// Save if the sets differ in either direction. Profiles are unique, so same count and all found means equal.
+	if (cache->magic == SDMMC_TUNING_CACHE_MAGIC && cache->count <= SDMMC_TUNING_PROFILES)
+	{
+		if (cache->count != (saved ? saved->count : 0))
+			save = true;
+
+		for (u32 i = 0; i < cache->count && !save; i++)
+		{
+			save = true;
+			for (u32 j = 0; saved && j < saved->count; j++)
+			{
+				if (!memcmp(&cache->profiles[i], &saved->profiles[j], sizeof(sdmmc_tuning_profile_t)))
+				{
+					save = false;
+					break;
+				}
+			}
+		}
+	}
+	else if (save)
+		sdmmc_storage_tuning_cache_reset(); // Only drops are pending. Save an empty cache.
+
+	// Drops are applied once the file is rewritten.
+	if (save && !sd_save_to_file(cache, sizeof(sdmmc_tuning_cache_t), SDMMC_TUNING_PATH))
+		sdmmc_storage_tuning_drop_reset();
+
+	free(saved);
+}
+
 #define NYX_VER_OFF 0x9C
 
 static void _nyx_load_run()
 {
-	u8 *nyx = sd_file_read("bootloader/sys/nyx.bin", NULL);
+	TRACE_BEGIN("nyx_load");
+	u8 *nyx = sd_file_read_lz4c("bootloader/sys/nyx.bin", NULL, 0, NULL);
+	TRACE_END("nyx_load");
 	if (!nyx)
 		return;
 
+	// Persist tuning profiles gathered in this session.
+	_sdmmc_tuning_cache_sync();
+
+	emmc_end_deferred();
 	sd_end();
 
 	render_static_bootlogo();
@@ -709,6 +771,8 @@ static void _nyx_load_run()
 	// Some cards (Sandisk U1), do not like a fast power cycle.
 	sdmmc_storage_init_wait_sd();
 
+	TRACE_MARK("nyx_jump");
+
 	void (*nyx_ptr)() = (void *)nyx;
 	(*nyx_ptr)();
 }
@@ -808,7 +872,10 @@ static void _auto_launch()
 	emummc_load_cfg();
 
 	// Parse hekate main configuration.
-	if (!ini_parse(&ini_sections, "bootloader/hekate_ipl.ini", false))
+	TRACE_BEGIN("ini_parse");
+	bool ini_parsed = ini_parse_cached(&ini_sections, "bootloader/hekate_ipl.ini", false, INI_CACHE_IPL);
+	TRACE_END("ini_parse");
+	if (!ini_parsed)
 		goto out; // Can't load hekate_ipl.ini.
 
 	// Load configuration.
@@ -899,7 +966,10 @@ static void _auto_launch()
 		boot_entry_id = 1;
 		bootlogoCustomEntry = NULL;
 
-		if (!ini_parse(&ini_list_sections, "bootloader/ini", true))
+		TRACE_BEGIN("ini_parse_list");
+		ini_parsed = ini_parse_cached(&ini_list_sections, "bootloader/ini", true, INI_CACHE_INI_DIR);
+		TRACE_END("ini_parse_list");
+		if (!ini_parsed)
 			goto skip_list;
 
 		LIST_FOREACH_ENTRY(ini_sec_t, ini_sec_list, &ini_list_sections, link)
@@ -1492,6 +1562,10 @@ void ipl_main()
 	// Tegra/Horizon configuration goes to 0x80000000+, package2 goes to 0xA9800000, we place our heap in between.
 	heap_init((void *)IPL_HEAP_START);
 
+	// Initialize boot profiler.
+	TRACE_INIT(TRACE_STAGE_IPL);
+	TRACE_MARK("ipl_main");
+
 #ifdef DEBUG_UART_PORT
 	uart_send(DEBUG_UART_PORT, (u8 *)"Hekate: Hola!\r\n", 16);
 	uart_wait_xfer(DEBUG_UART_PORT, UART_TX_IDLE);
@@ -1507,10 +1581,26 @@ void ipl_main()
 	max77620_rtc_prep_read();
 
 	// Initialize display.
+	TRACE_BEGIN("display_init");
 	display_init();
+	TRACE_END("display_init");
+
+	// Start eMMC init. SD init advances it while waiting and first eMMC user finishes it.
+	TRACE_BEGIN("emmc_init_start");
+	emmc_initialize_start();
+	TRACE_END("emmc_init_start");
 
 	// Mount SD Card.
+	TRACE_BEGIN("sd_mount");
 	h_cfg.errors |= !sd_mount() ? ERR_SD_BOOT_EN : 0;
+	TRACE_END("sd_mount");
+
+	// Load known good SD/eMMC tuning profiles.
+	if (!(h_cfg.errors & ERR_SD_BOOT_EN))
+		_sdmmc_tuning_cache_sync();
+
+	// Modules from a previous run can't be trusted.
+	ianos_cache_reset();
 
 	// Check if watchdog was fired previously.
 	if (watchdog_fired())
@@ -1525,8 +1615,10 @@ void ipl_main()
 		h_cfg.errors |= ERR_LIBSYS_LP0;
 
 	// Train DRAM and switch to max frequency.
+	TRACE_BEGIN("minerva_init");
 	if (minerva_init()) //!TODO: Add Tegra210B01 support to minerva.
 		h_cfg.errors |= ERR_LIBSYS_MTC;
+	TRACE_END("minerva_init");
 
 	// Disable watchdog protection.
 	watchdog_end();
@@ -1554,7 +1646,9 @@ skip_lp0_minerva_config:
 	if (!(h_cfg.errors & ERR_SD_BOOT_EN))
 		_auto_launch();
 
-	// Failed to launch Nyx, unmount SD Card.
+	// Failed to launch Nyx, save boot trace and unmount SD Card.
+	TRACE_MARK("menu");
+	TRACE_EXPORT("bootloader/trace.json");
 	sd_end();
 
 	// Set ram to a freq that doesn't need periodic training.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022 CTCaer
+ * Copyright (c) 2019-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -32,7 +32,6 @@ void emummc_load_cfg()
 	emu_cfg.path = NULL;
 	emu_cfg.sector = 0;
 	emu_cfg.id = 0;
-	emu_cfg.file_based_part_size = 0;
 	emu_cfg.active_part = 0;
 	emu_cfg.fs_ver = 0;
 	if (!emu_cfg.nintendo_path)
@@ -132,17 +131,146 @@ static int emummc_raw_get_part_off(int part_idx)
 	return 2;
 }
 
+static void _emummc_file_map_free()
+{
+	for (u32 i = 0; i < EMUMMC_FILE_MAPS; i++)
+	{
+		free(emu_cfg.file_map[i].extents);
+		memset(&emu_cfg.file_map[i], 0, sizeof(emummc_file_map_t));
+	}
+}
+
+static int _emummc_file_map_add(emummc_file_map_t *map, const char *path)
+{
+	FIL fp;
+	FRESULT res;
+	DWORD *clmt;
+	u32 clmt_size = 64;
+
+	if (f_open(&fp, path, FA_READ))
+		return 0;
+
+	// Walk the FAT chain once. If the table is too small, FatFs reports the needed size.
+	while (true)
+	{
+		clmt = (DWORD *)malloc(clmt_size * sizeof(DWORD));
+		clmt[0] = clmt_size;
+		fp.cltbl = clmt;
+
+		res = f_lseek(&fp, CREATE_LINKMAP);
+		if (res != FR_NOT_ENOUGH_CORE)
+			break;
+
+		clmt_size = clmt[0];
+		free(clmt);
+	}
+
+	FATFS *fs = fp.obj.fs;
+	u32 file_sectors = f_size(&fp) >> 9;
+	fp.cltbl = NULL;
+	f_close(&fp);
+
+	if (res || !file_sectors)
+	{
+		free(clmt);
+		return 0;
+	}
+
+	// Grow extent table. Worst case, no fragment gets merged.
+	u32 frags = (clmt[0] - 2) / 2;
+	emummc_extent_t *extents = (emummc_extent_t *)malloc((map->count + frags) * sizeof(emummc_extent_t));
+	if (map->count)
+		memcpy(extents, map->extents, map->count * sizeof(emummc_extent_t));
+	free(map->extents);
+	map->extents = extents;
+
+	// Convert cluster runs to SD LBA runs. Clusters past the file size are not mapped.
+	DWORD *frag = &clmt[1];
+	while (*frag && file_sectors)
+	{
+		u32 lba   = fs->database + (frag[1] - 2) * fs->csize;
+		u32 count = MIN(frag[0] * fs->csize, file_sectors);
+
+		emummc_extent_t *prev = map->count ? &map->extents[map->count - 1] : NULL;
+		if (prev && (prev->lba + prev->count) == lba)
+			prev->count += count;
+		else
+		{
+			map->extents[map->count].sector = map->sectors;
+			map->extents[map->count].lba    = lba;
+			map->extents[map->count].count  = count;
+			map->count++;
+		}
+
+		map->sectors += count;
+		file_sectors -= count;
+		frag += 2;
+	}
+
+	free(clmt);
+
+	return 1;
+}
+
+static int _emummc_file_map_init()
+{
+	char *path = emu_cfg.emummc_file_based_path;
+
+	_emummc_file_map_free();
+
+	strcpy(path, emu_cfg.path);
+	strcat(path, "/eMMC/");
+	char *name = path + strlen(path);
+
+	// Map all split parts of GPP into one sector space.
+	for (u32 i = 0; i < 100; i++)
+	{
+		name[0] = '0' + i / 10;
+		name[1] = '0' + i % 10;
+		name[2] = 0;
+
+		if (f_stat(path, NULL))
+			break;
+
+		if (!_emummc_file_map_add(&emu_cfg.file_map[EMMC_GPP], path))
+			goto error;
+	}
+
+	if (!emu_cfg.file_map[EMMC_GPP].count)
+		goto error;
+
+	strcpy(name, "BOOT0");
+	if (!_emummc_file_map_add(&emu_cfg.file_map[EMMC_BOOT0], path))
+		goto error;
+
+	strcpy(name, "BOOT1");
+	if (!_emummc_file_map_add(&emu_cfg.file_map[EMMC_BOOT1], path))
+		goto error;
+
+	return 1;
+
+error:
+	_emummc_file_map_free();
+
+	return 0;
+}
+
 int emummc_storage_init_mmc()
 {
 	FILINFO fno;
+	int res = 0;
 	emu_cfg.active_part = 0;
 
+	// The emuMMC config may have changed.
+	emmc_cache_reset();
+
 	// Always init eMMC even when in emuMMC. eMMC is needed from the emuMMC driver anyway.
-	if (!emmc_initialize(false))
-		return 2;
+	// Finish it after the SD Card, so the card waits of both overlap.
+	TRACE_BEGIN("emmc_init");
+	emmc_initialize_start();
 
 	if (!emu_cfg.enabled || h_cfg.emummc_force_disable)
-		return 0;
+		goto emmc_finish;
 
 	if (!sd_mount())
 		goto out;
@@ -159,23 +287,30 @@ int emummc_storage_init_mmc()
 		}
 		f_chmod(emu_cfg.emummc_file_based_path, AM_ARC, AM_ARC);
 
-		strcat(emu_cfg.emummc_file_based_path, "/00");
-		if (f_stat(emu_cfg.emummc_file_based_path, &fno))
+		if (!_emummc_file_map_init())
 		{
 			EPRINTF("Error al abrir EmuNAND rawnand.");
 			goto out;
 		}
-		emu_cfg.file_based_part_size = fno.fsize >> 9;
 	}
 
-	return 0;
+	goto emmc_finish;
 
 out:
-	return 1;
+	res = 1;
+
+emmc_finish:
+	if (!emmc_initialize_finish())
+		res = 2;
+	TRACE_END("emmc_init");
+
+	return res;
 }
 
 int emummc_storage_end()
 {
+	_emummc_file_map_free();
+
 	if (!emu_cfg.enabled || h_cfg.emummc_force_disable)
 		emmc_end();
 	else
@@ -184,12 +319,51 @@ int emummc_storage_end()
 	return 1;
 }
 
-int emummc_storage_read(u32 sector, u32 num_sectors, void *buf)
+static int _emummc_file_readwrite(u32 sector, u32 num_sectors, u8 *buf, bool is_write)
 {
-	FIL fp;
-	if (!emu_cfg.enabled || h_cfg.emummc_force_disable)
-		return sdmmc_storage_read(&emmc_storage, sector, num_sectors, buf);
-	else if (emu_cfg.sector)
+	emummc_file_map_t *map = &emu_cfg.file_map[emu_cfg.active_part];
+
+	// Find the extent that holds the first sector.
+	u32 first = 0;
+	u32 last  = map->count;
+	while (first < last)
+	{
+		u32 mid = (first + last) / 2;
+		if (sector >= (map->extents[mid].sector + map->extents[mid].count))
+			first = mid + 1;
+		else
+			last = mid;
+	}
+
+	// Issue one raw SD transfer per contiguous run. Extents are back to back, so this also crosses parts.
+	for (u32 i = first; num_sectors; i++)
+	{
+		if (i >= map->count)
+			return 0;
+
+		emummc_extent_t *extent = &map->extents[i];
+		u32 offset = sector - extent->sector;
+		u32 count  = MIN(num_sectors, extent->count - offset);
+
+		int res;
+		if (!is_write)
+			res = sdmmc_storage_read(&sd_storage, extent->lba + offset, count, buf);
+		else
+			res = sdmmc_storage_write(&sd_storage, extent->lba + offset, count, buf);
+		if (!res)
+			return 0;
+
+		sector      += count;
+		num_sectors -= count;
+		buf         += (u64)count << 9;
+	}
+
+	return 1;
+}
+
+static int _emummc_storage_read(u32 sector, u32 num_sectors, void *buf)
+{
+	if (emu_cfg.sector)
 	{
 		sector += emu_cfg.sector;
 		sector += emummc_raw_get_part_off(emu_cfg.active_part) * 0x2000;
@@ -197,106 +371,52 @@ int emummc_storage_read(u32 sector, u32 num_sectors, void *buf)
 	}
 	else
 	{
-		if (!emu_cfg.active_part)
-		{
-			u32 file_part = sector / emu_cfg.file_based_part_size;
-			sector = sector % emu_cfg.file_based_part_size;
-			if (file_part >= 10)
-				itoa(file_part, emu_cfg.emummc_file_based_path + strlen(emu_cfg.emummc_file_based_path) - 2, 10);
-			else
-			{
-				emu_cfg.emummc_file_based_path[strlen(emu_cfg.emummc_file_based_path) - 2] = '0';
-				itoa(file_part, emu_cfg.emummc_file_based_path + strlen(emu_cfg.emummc_file_based_path) - 1, 10);
-			}
-		}
-		if (f_open(&fp, emu_cfg.emummc_file_based_path, FA_READ))
-		{
-			EPRINTF("Error al abrir imagen de EmuNAND.");
-			return 0;
-		}
-		f_lseek(&fp, (u64)sector << 9);
-		if (f_read(&fp, buf, (u64)num_sectors << 9, NULL))
+		if (!_emummc_file_readwrite(sector, num_sectors, buf, false))
 		{
 			EPRINTF("Error al leer imagen de EmuNAND.");
-			f_close(&fp);
 			return 0;
 		}
 
-		f_close(&fp);
 		return 1;
 	}
+}
 
-	return 1;
+int emummc_storage_read(u32 sector, u32 num_sectors, void *buf)
+{
+	if (!emu_cfg.enabled || h_cfg.emummc_force_disable)
+		return emmc_read_cached(sector, num_sectors, buf);
+
+	return emmc_cache_read(EMMC_CACHE_DEV_EMUMMC, emu_cfg.active_part, sector, num_sectors, buf, _emummc_storage_read);
 }
 
 int emummc_storage_write(u32 sector, u32 num_sectors, void *buf)
 {
-	FIL fp;
 	if (!emu_cfg.enabled || h_cfg.emummc_force_disable)
+	{
+		emmc_cache_invalidate(EMMC_CACHE_DEV_EMMC, emmc_storage.partition, sector, num_sectors);
+
 		return sdmmc_storage_write(&emmc_storage, sector, num_sectors, buf);
-	else if (emu_cfg.sector)
+	}
+
+	emmc_cache_invalidate(EMMC_CACHE_DEV_EMUMMC, emu_cfg.active_part, sector, num_sectors);
+
+	if (emu_cfg.sector)
 	{
 		sector += emu_cfg.sector;
 		sector += emummc_raw_get_part_off(emu_cfg.active_part) * 0x2000;
 		return sdmmc_storage_write(&sd_storage, sector, num_sectors, buf);
 	}
 	else
-	{
-		if (!emu_cfg.active_part)
-		{
-			u32 file_part = sector / emu_cfg.file_based_part_size;
-			sector = sector % emu_cfg.file_based_part_size;
-			if (file_part >= 10)
-				itoa(file_part, emu_cfg.emummc_file_based_path + strlen(emu_cfg.emummc_file_based_path) - 2, 10);
-			else
-			{
-				emu_cfg.emummc_file_based_path[strlen(emu_cfg.emummc_file_based_path) - 2] = '0';
-				itoa(file_part, emu_cfg.emummc_file_based_path + strlen(emu_cfg.emummc_file_based_path) - 1, 10);
-			}
-		}
-
-		if (f_open(&fp, emu_cfg.emummc_file_based_path, FA_WRITE))
-			return 0;
-
-		f_lseek(&fp, (u64)sector << 9);
-		if (f_write(&fp, buf, (u64)num_sectors << 9, NULL))
-		{
-			f_close(&fp);
-			return 0;
-		}
-
-		f_close(&fp);
-		return 1;
-	}
+		return _emummc_file_readwrite(sector, num_sectors, buf, true);
 }
 
 int emummc_storage_set_mmc_partition(u32 partition)
 {
 	emu_cfg.active_part = partition;
-	emmc_set_partition(partition);
 
-	if (!emu_cfg.enabled || h_cfg.emummc_force_disable || emu_cfg.sector)
-		return 1;
-	else
-	{
-		strcpy(emu_cfg.emummc_file_based_path, emu_cfg.path);
-		strcat(emu_cfg.emummc_file_based_path, "/eMMC");
-
-		switch (partition)
-		{
-		case 0:
-			strcat(emu_cfg.emummc_file_based_path, "/00");
-			break;
-		case 1:
-			strcat(emu_cfg.emummc_file_based_path, "/BOOT0");
-			break;
-		case 2:
-			strcat(emu_cfg.emummc_file_based_path, "/BOOT1");
-			break;
-		}
-
-		return 1;
-	}
+	// The real eMMC partition is only needed in sysMMC mode.
+	if (!emu_cfg.enabled || h_cfg.emummc_force_disable)
+		emmc_set_partition(partition);
 
 	return 1;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021 CTCaer
+ * Copyright (c) 2019-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -32,6 +32,22 @@ typedef enum {
 	EMUMMC_MMC_GC   = 2,
 } emummc_mmc_t;
 
+#define EMUMMC_FILE_MAPS 3 // GPP, BOOT0, BOOT1.
+
+typedef struct _emummc_extent_t
+{
+	u32 sector; // Sector in partition.
+	u32 lba;    // SD sector.
+	u32 count;
+} emummc_extent_t;
+
+typedef struct _emummc_file_map_t
+{
+	u32 sectors;
+	u32 count;
+	emummc_extent_t *extents;
+} emummc_file_map_t;
+
 typedef struct _emummc_cfg_t
 {
 	int   enabled;
@@ -41,7 +57,7 @@ typedef struct _emummc_cfg_t
 	char *nintendo_path;
 	// Internal.
 	char *emummc_file_based_path;
-	u32 file_based_part_size;
+	emummc_file_map_t file_map[EMUMMC_FILE_MAPS];
 	u32 active_part;
 	int fs_ver;
 } emummc_cfg_t;
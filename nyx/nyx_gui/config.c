@@ -60,6 +60,7 @@ void set_nyx_default_configuration()
 	n_cfg.jc_disable     = 0;
 	n_cfg.jc_force_right = 0;
 	n_cfg.bpmp_clock     = 0;
+	n_cfg.dram_idle      = 1000;
 }
 
 int create_config_entry()
@@ -73,7 +74,7 @@ int create_config_entry()
 
 	LIST_INIT(ini_sections);
 
-	if (ini_parse(&ini_sections, "bootloader/hekate_ipl.ini", false))
+	if (ini_parse_cached(&ini_sections, "bootloader/hekate_ipl.ini", false, INI_CACHE_IPL))
 		mainIniFound = true;
 	else
 	{
@@ -96,6 +97,9 @@ int create_config_entry()
 	if (f_open(&fp, "bootloader/hekate_ipl.ini", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)
 		return 1;
 
+	// Source is rewritten. Same size edits within FAT's 2s resolution are not caught by the snapshot key.
+	ini_cache_invalidate(INI_CACHE_IPL);
+
 	// Add config entry.
 	f_puts("[config]\nautoboot=", &fp);
 	itoa(h_cfg.autoboot, lbuf, 10);
@@ -246,6 +250,10 @@ int create_nyx_config_entry(bool force_unmount)
 	itoa(n_cfg.bpmp_clock, lbuf, 10);
 	f_puts(lbuf, &fp);
 
+	f_puts("\ndramidle=", &fp);
+	itoa(n_cfg.dram_idle, lbuf, 10);
+	f_puts(lbuf, &fp);
+
 	f_puts("\n", &fp);
 
 	f_close(&fp);
@@ -24,6 +24,7 @@
 #include <bdk.h>
 
 #include "gui.h"
+#include "gui_progress.h"
 #include "fe_emmc_tools.h"
 #include "fe_emummc_tools.h"
 #include "../config.h"
@@ -142,7 +143,6 @@ static int _dump_emmc_verify(emmc_tool_gui_t *gui, sdmmc_storage_t *storage, u32
 	FIL fp;
 	FIL hashFp;
 	u8 sparseShouldVerify = 4;
-	u32 prevPct = 200;
 	u32 sdFileSector = 0;
 	int res = 0;
 	const char hexa[] = "0123456789abcdef";
@@ -187,13 +187,11 @@ static int _dump_emmc_verify(emmc_tool_gui_t *gui, sdmmc_storage_t *storage, u32
 		u8 *bufEm = (u8 *)EMMC_BUF_ALIGNED;
 		u8 *bufSd = (u8 *)SDXC_BUF_ALIGNED;
 
-		u32 pct = (u64)((u64)(lba_curr - part->lba_start) * 100u) / (u64)(part->lba_end - part->lba_start);
-		lv_bar_set_value(gui->bar, pct);
+		gui_progress_t prog;
+		gui_progress_init(&prog, gui->bar, gui->label_pct, part->lba_end - part->lba_start);
 		lv_bar_set_style(gui->bar, LV_BAR_STYLE_BG, gui->bar_teal_bg);
 		lv_bar_set_style(gui->bar, LV_BAR_STYLE_INDIC, gui->bar_teal_ind);
-		s_printf(gui->txt_buf, " "SYMBOL_DOT" %d%%", pct);
-		lv_label_set_text(gui->label_pct, gui->txt_buf);
-		manual_system_maintenance(true);
+		gui_progress_post(&prog, lba_curr - part->lba_start);
 
 		clmt = f_expand_cltbl(&fp, SZ_4M, 0);
 
@@ -282,17 +280,7 @@ static int _dump_emmc_verify(emmc_tool_gui_t *gui, sdmmc_storage_t *storage, u32
 				}
 			}
 
-			pct = (u64)((u64)(lba_curr - part->lba_start) * 100u) / (u64)(part->lba_end - part->lba_start);
-			if (pct != prevPct)
-			{
-				lv_bar_set_value(gui->bar, pct);
-				s_printf(gui->txt_buf, " "SYMBOL_DOT" %d%%", pct);
-				lv_label_set_text(gui->label_pct, gui->txt_buf);
-				manual_system_maintenance(true);
-				prevPct = pct;
-			}
-
-			manual_system_maintenance(false);
+			gui_progress_post(&prog, lba_curr - part->lba_start);
 
 			lba_curr += num;
 			totalSectorsVer -= num;
@@ -319,10 +307,7 @@ static int _dump_emmc_verify(emmc_tool_gui_t *gui, sdmmc_storage_t *storage, u32
 		f_close(&fp);
 		f_close(&hashFp);
 
-		lv_bar_set_value(gui->bar, pct);
-		s_printf(gui->txt_buf, " "SYMBOL_DOT" %d%%", pct);
-		lv_label_set_text(gui->label_pct, gui->txt_buf);
-		manual_system_maintenance(true);
+		gui_progress_render(&prog);
 
 		return 0;
 	}
@@ -504,9 +489,9 @@ static int _dump_emmc_part(emmc_tool_gui_t *gui, char *sd_path, int active_part,
 	u32 lba_curr = part->lba_start;
 	u32 lbaStartPart = part->lba_start;
 	u32 bytesWritten = 0;
-	u32 prevPct = 200;
 	int retryCount = 0;
 	DWORD *clmt = NULL;
+	gui_progress_t prog;
 
 	// Continue from where we left, if Partial Backup in progress.
 	if (partialDumpInProgress)
@@ -522,8 +507,8 @@ static int _dump_emmc_part(emmc_tool_gui_t *gui, char *sd_path, int active_part,
 		clmt = f_expand_cltbl(&fp, SZ_4M, MIN(totalSize, multipartSplitSize));
 
 	u32 num = 0;
-	u32 pct = 0;
 
+	gui_progress_init(&prog, gui->bar, gui->label_pct, lba_end - part->lba_start);
 	lv_obj_set_opa_scale(gui->bar, LV_OPA_COVER);
 	lv_obj_set_opa_scale(gui->label_pct, LV_OPA_COVER);
 	while (totalSectors > 0)
@@ -548,6 +533,7 @@ static int _dump_emmc_part(emmc_tool_gui_t *gui, char *sd_path, int active_part,
 				}
 				lv_bar_set_style(gui->bar, LV_BAR_STYLE_BG, lv_theme_get_current()->bar.bg);
 				lv_bar_set_style(gui->bar, LV_BAR_STYLE_INDIC, gui->bar_white_ind);
+				gui_progress_init(&prog, gui->bar, gui->label_pct, lba_end - part->lba_start);
 			}
 
 			_update_filename(outFilename, sdPathLen, currPartIdx);
@@ -666,18 +652,7 @@ static int _dump_emmc_part(emmc_tool_gui_t *gui, char *sd_path, int active_part,
 			return 0;
 		}
 
-		manual_system_maintenance(false);
-
-		pct = (u64)((u64)(lba_curr - part->lba_start) * 100u) / (u64)(lba_end - part->lba_start);
-		if (pct != prevPct)
-		{
-			lv_bar_set_value(gui->bar, pct);
-			s_printf(gui->txt_buf, " "SYMBOL_DOT" %d%%", pct);
-			lv_label_set_text(gui->label_pct, gui->txt_buf);
-			manual_system_maintenance(true);
-
-			prevPct = pct;
-		}
+		gui_progress_post(&prog, lba_curr - part->lba_start);
 
 		lba_curr += num;
 		totalSectors -= num;
@@ -706,9 +681,7 @@ static int _dump_emmc_part(emmc_tool_gui_t *gui, char *sd_path, int active_part,
 			return 0;
 		}
 	}
-	lv_bar_set_value(gui->bar, 100);
-	lv_label_set_text(gui->label_pct, " "SYMBOL_DOT" 100%");
-	manual_system_maintenance(true);
+	gui_progress_done(&prog);
 
 	// Backup operation ended successfully.
 	f_close(&fp);
@@ -725,9 +698,7 @@ static int _dump_emmc_part(emmc_tool_gui_t *gui, char *sd_path, int active_part,
 
 			return 0;
 		}
-		lv_bar_set_value(gui->bar, 100);
-		lv_label_set_text(gui->label_pct, " "SYMBOL_DOT" 100%");
-		manual_system_maintenance(true);
+		gui_progress_done(&prog);
 	}
 
 	// Remove partial backup index file if no fatal errors occurred.
@@ -957,6 +928,9 @@ static int _restore_emmc_part(emmc_tool_gui_t *gui, char *sd_path, int active_pa
 	FIL fp;
 	FILINFO fno;
 
+	// Restored data bypasses the raw block cache.
+	emmc_cache_reset();
+
 	lv_bar_set_value(gui->bar, 0);
 	lv_label_set_text(gui->label_pct, " "SYMBOL_DOT" 0%");
 	lv_bar_set_style(gui->bar, LV_BAR_STYLE_BG, lv_theme_get_current()->bar.bg);
@@ -1169,11 +1143,10 @@ multipart_not_allowed:
 
 	u32 lba_curr = part->lba_start;
 	u32 bytesWritten = 0;
-	u32 prevPct = 200;
 	int retryCount = 0;
 
 	u32 num = 0;
-	u32 pct = 0;
+	gui_progress_t prog;
 
 	DWORD *clmt = f_expand_cltbl(&fp, SZ_4M, 0);
 
@@ -1195,6 +1168,7 @@ multipart_not_allowed:
 		sd_sector_off = sector_start + (0x2000 * active_part);
 	}
 
+	gui_progress_init(&prog, gui->bar, gui->label_pct, lba_end - part->lba_start);
 	lv_obj_set_opa_scale(gui->bar, LV_OPA_COVER);
 	lv_obj_set_opa_scale(gui->label_pct, LV_OPA_COVER);
 	while (totalSectors > 0)
@@ -1219,6 +1193,7 @@ multipart_not_allowed:
 
 					return 0;
 				}
+				gui_progress_init(&prog, gui->bar, gui->label_pct, lba_end - part->lba_start);
 			}
 
 			_update_filename(outFilename, sdPathLen, currPartIdx);
@@ -1308,23 +1283,13 @@ multipart_not_allowed:
 				res = !sdmmc_storage_write(&sd_storage, lba_curr + sd_sector_off, num, buf);
 			manual_system_maintenance(false);
 		}
-		pct = (u64)((u64)(lba_curr - part->lba_start) * 100u) / (u64)(lba_end - part->lba_start);
-		if (pct != prevPct)
-		{
-			lv_bar_set_value(gui->bar, pct);
-			s_printf(gui->txt_buf, " "SYMBOL_DOT" %d%%", pct);
-			lv_label_set_text(gui->label_pct, gui->txt_buf);
-			manual_system_maintenance(true);
-			prevPct = pct;
-		}
+		gui_progress_post(&prog, lba_curr - part->lba_start);
 
 		lba_curr += num;
 		totalSectors -= num;
 		bytesWritten += num * EMMC_BLOCKSIZE;
 	}
-	lv_bar_set_value(gui->bar, 100);
-	lv_label_set_text(gui->label_pct, " "SYMBOL_DOT" 100%");
-	manual_system_maintenance(true);
+	gui_progress_done(&prog);
 
 	// Restore operation ended successfully.
 	f_close(&fp);
@@ -1341,9 +1306,7 @@ multipart_not_allowed:
 
 			return 0;
 		}
-		lv_bar_set_value(gui->bar, 100);
-		lv_label_set_text(gui->label_pct, " "SYMBOL_DOT" 100%");
-		manual_system_maintenance(true);
+		gui_progress_done(&prog);
 	}
 
 	if (gui->raw_emummc)
@@ -1,7 +1,7 @@
 /*
  * Copyright (c) 2018 naehrwert
  * Copyright (c) 2018 Rajko Stojadinovic
- * Copyright (c) 2018-2022 CTCaer
+ * Copyright (c) 2018-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -24,6 +24,7 @@
 #include <bdk.h>
 
 #include "gui.h"
+#include "gui_progress.h"
 #include "fe_emummc_tools.h"
 #include "../config.h"
 #include <libs/fatfs/diskio.h>
@@ -143,6 +144,28 @@ void update_emummc_base_folder(char *outFilename, u32 sdPathLen, u32 currPartIdx
 		itoa(currPartIdx, &outFilename[sdPathLen], 10);
 }
 
+static int _emummc_file_alloc(emmc_tool_gui_t *gui, FIL *fp, const char *path, u64 size)
+{
+	// Allocate the whole part as one cluster run, so it can be accessed as a single extent.
+	int res = f_expand(fp, size, 1);
+	if (res)
+	{
+		if (res == FR_DENIED)
+			s_printf(gui->txt_buf, "\n#FF0000 No hay espacio contiguo para#\n#FFDD00 %s#\n", path);
+		else
+			s_printf(gui->txt_buf, "\n#FF0000 Error (%d) reservando#\n#FFDD00 %s#\n", res, path);
+		lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, gui->txt_buf);
+		manual_system_maintenance(true);
+
+		f_close(fp);
+		f_unlink(path);
+
+		return 0;
+	}
+
+	return 1;
+}
+
 static int _dump_emummc_file_part(emmc_tool_gui_t *gui, char *sd_path, sdmmc_storage_t *storage, emmc_part_t *part)
 {
 	static const u32 FAT32_FILESIZE_LIMIT = 0xFFFFFFFF;
@@ -206,19 +229,19 @@ static int _dump_emummc_file_part(emmc_tool_gui_t *gui, char *sd_path, sdmmc_sto
 
 	u32 lba_curr = part->lba_start;
 	u32 bytesWritten = 0;
-	u32 prevPct = 200;
 	int retryCount = 0;
 	DWORD *clmt = NULL;
+	gui_progress_t prog;
 
 	u64 totalSize = (u64)((u64)totalSectors << 9);
-	if (totalSize <= FAT32_FILESIZE_LIMIT)
-		clmt = f_expand_cltbl(&fp, SZ_4M, totalSize);
-	else
-		clmt = f_expand_cltbl(&fp, SZ_4M, MIN(totalSize, multipartSplitSize));
+	u64 fileSize = totalSize <= FAT32_FILESIZE_LIMIT ? totalSize : MIN(totalSize, multipartSplitSize);
+	if (!_emummc_file_alloc(gui, &fp, outFilename, fileSize))
+		return 0;
+	clmt = f_expand_cltbl(&fp, SZ_4M, fileSize);
 
 	u32 num = 0;
-	u32 pct = 0;
 
+	gui_progress_init(&prog, gui->bar, gui->label_pct, part->lba_end - part->lba_start);
 	lv_obj_set_opa_scale(gui->bar, LV_OPA_COVER);
 	lv_obj_set_opa_scale(gui->label_pct, LV_OPA_COVER);
 	while (totalSectors > 0)
@@ -251,7 +274,10 @@ static int _dump_emummc_file_part(emmc_tool_gui_t *gui, char *sd_path, sdmmc_sto
 			bytesWritten = 0;
 
 			totalSize = (u64)((u64)totalSectors << 9);
-			clmt = f_expand_cltbl(&fp, SZ_4M, MIN(totalSize, multipartSplitSize));
+			fileSize = MIN(totalSize, multipartSplitSize);
+			if (!_emummc_file_alloc(gui, &fp, outFilename, fileSize))
+				return 0;
+			clmt = f_expand_cltbl(&fp, SZ_4M, fileSize);
 		}
 
 		// Check for cancellation combo.
@@ -321,16 +347,7 @@ static int _dump_emummc_file_part(emmc_tool_gui_t *gui, char *sd_path, sdmmc_sto
 
 			return 0;
 		}
-		pct = (u64)((u64)(lba_curr - part->lba_start) * 100u) / (u64)(part->lba_end - part->lba_start);
-		if (pct != prevPct)
-		{
-			lv_bar_set_value(gui->bar, pct);
-			s_printf(gui->txt_buf, " "SYMBOL_DOT" %d%%", pct);
-			lv_label_set_text(gui->label_pct, gui->txt_buf);
-			manual_system_maintenance(true);
-
-			prevPct = pct;
-		}
+		gui_progress_post(&prog, lba_curr - part->lba_start);
 
 		lba_curr += num;
 		totalSectors -= num;
@@ -342,12 +359,8 @@ static int _dump_emummc_file_part(emmc_tool_gui_t *gui, char *sd_path, sdmmc_sto
 			f_sync(&fp);
 			bytesWritten = 0;
 		}
-
-		manual_system_maintenance(false);
 	}
-	lv_bar_set_value(gui->bar, 100);
-	lv_label_set_text(gui->label_pct, " "SYMBOL_DOT" 100%");
-	manual_system_maintenance(true);
+	gui_progress_done(&prog);
 
 	// Operation ended successfully.
 	f_close(&fp);
@@ -506,13 +519,260 @@ out:
 	sd_unmount();
 }
 
+static int _emummc_file_extents(const char *path)
+{
+	FIL fp;
+
+	if (f_open(&fp, path, FA_READ))
+		return 0;
+
+	DWORD *clmt = f_expand_cltbl(&fp, SZ_4M, 0);
+	int extents = clmt ? (clmt[0] - 2) / 2 : 0;
+
+	f_close(&fp);
+	free(clmt);
+
+	return extents;
+}
+
+static int _defrag_emummc_file_part(emmc_tool_gui_t *gui, const char *path)
+{
+	FIL fp_src;
+	FIL fp_dst;
+	gui_progress_t prog;
+	char tmp_path[OUT_FILENAME_SZ];
+	char bak_path[OUT_FILENAME_SZ];
+	u8 *buf = (u8 *)MIXD_BUF_ALIGNED;
+
+	s_printf(tmp_path, "%s.tmp", path);
+	s_printf(bak_path, "%s.bak", path);
+
+	int res = f_open(&fp_src, path, FA_READ);
+	if (res)
+	{
+		s_printf(gui->txt_buf, "\n#FF0000 Error (%d) abriendo#\n#FFDD00 %s#\n", res, path);
+		lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, gui->txt_buf);
+		manual_system_maintenance(true);
+
+		return 0;
+	}
+
+	u64 size = f_size(&fp_src);
+	u32 totalSectors = size >> 9;
+	DWORD *clmt_src = f_expand_cltbl(&fp_src, SZ_4M, 0);
+
+	res = f_open(&fp_dst, tmp_path, FA_CREATE_ALWAYS | FA_WRITE);
+	if (res)
+	{
+		s_printf(gui->txt_buf, "\n#FF0000 Error (%d) creando#\n#FFDD00 %s#\n", res, tmp_path);
+		lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, gui->txt_buf);
+		manual_system_maintenance(true);
+
+		goto out_src;
+	}
+
+	if (!_emummc_file_alloc(gui, &fp_dst, tmp_path, size))
+		goto out_src;
+	DWORD *clmt_dst = f_expand_cltbl(&fp_dst, SZ_4M, size);
+
+	lv_bar_set_value(gui->bar, 0);
+	lv_label_set_text(gui->label_pct, " "SYMBOL_DOT" 0%");
+	lv_obj_set_opa_scale(gui->bar, LV_OPA_COVER);
+	lv_obj_set_opa_scale(gui->label_pct, LV_OPA_COVER);
+	manual_system_maintenance(true);
+
+	u32 sector = 0;
+	gui_progress_init(&prog, gui->bar, gui->label_pct, totalSectors);
+	while (sector < totalSectors)
+	{
+		// Check for cancellation combo.
+		if (btn_read_vol() == (BTN_VOL_UP | BTN_VOL_DOWN))
+		{
+			s_printf(gui->txt_buf, "\n#FFDD00 La desfragmentacion fue cancelada!#\n");
+			lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, gui->txt_buf);
+			manual_system_maintenance(true);
+
+			msleep(1000);
+
+			res = 1;
+			break;
+		}
+
+		u32 num = MIN(totalSectors - sector, NUM_SECTORS_PER_ITER);
+
+		res = f_read_fast(&fp_src, buf, num << 9);
+		if (!res)
+			res = f_write_fast(&fp_dst, buf, num << 9);
+		if (res)
+		{
+			s_printf(gui->txt_buf, "\n#FF0000 Error fatal (%d) copiando en la SD#\nIntentalo de nuevo...\n", res);
+			lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, gui->txt_buf);
+			manual_system_maintenance(true);
+
+			break;
+		}
+
+		sector += num;
+		gui_progress_post(&prog, sector);
+		manual_system_maintenance(false);
+	}
+	gui_progress_done(&prog);
+
+	f_close(&fp_dst);
+	free(clmt_dst);
+	f_close(&fp_src);
+	free(clmt_src);
+
+	// Replace the fragmented part only after a full copy.
+	if (res)
+	{
+		f_unlink(tmp_path);
+
+		return 0;
+	}
+
+	// Keep the original until the copy is in place.
+	f_unlink(bak_path);
+	res = f_rename(path, bak_path);
+	if (res)
+	{
+		f_unlink(tmp_path);
+		goto out_rename;
+	}
+
+	res = f_rename(tmp_path, path);
+	if (res)
+	{
+		// Restore the original. Keep the copy if that fails too.
+		if (!f_rename(bak_path, path))
+			f_unlink(tmp_path);
+		goto out_rename;
+	}
+
+	res = f_unlink(bak_path);
+	if (res)
+	{
+		s_printf(gui->txt_buf, "\n#FF0000 Error (%d) borrando#\n#FFDD00 %s#\n", res, bak_path);
+		lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, gui->txt_buf);
+		manual_system_maintenance(true);
+
+		return 0;
+	}
+
+	return 1;
+
+out_rename:
+	s_printf(gui->txt_buf, "\n#FF0000 Error (%d) reemplazando#\n#FFDD00 %s#\n", res, path);
+	lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, gui->txt_buf);
+	manual_system_maintenance(true);
+
+	return 0;
+
+out_src:
+	f_close(&fp_src);
+	free(clmt_src);
+
+	return 0;
+}
+
+void defrag_emummc_file(emmc_tool_gui_t *gui)
+{
+	int res = 1;
+	u32 timer = 0;
+	u32 parts = 0;
+	u32 extents = 0;
+	emummc_cfg_t emu_info;
+
+	char *txt_buf = (char *)malloc(SZ_16K);
+	char *path = (char *)malloc(OUT_FILENAME_SZ);
+	gui->txt_buf = txt_buf;
+
+	txt_buf[0] = 0;
+	lv_label_set_text(gui->label_log, txt_buf);
+
+	manual_system_maintenance(true);
+
+	if (!sd_mount())
+	{
+		lv_label_set_text(gui->label_info, "#FFDD00 Error al iniciar la SD!#");
+		goto out;
+	}
+
+	load_emummc_cfg(&emu_info);
+	if (!emu_info.enabled || emu_info.sector || !emu_info.path)
+	{
+		lv_label_set_text(gui->label_info, "#FFDD00 La EmuNAND activa no es de archivo SD!#");
+		goto out_cfg;
+	}
+
+	s_printf(txt_buf, "#96FF00 Carp. base:#\n%s/eMMC\n\n", emu_info.path);
+	lv_label_set_text(gui->label_info, txt_buf);
+	manual_system_maintenance(true);
+
+	s_printf(path, "%s/eMMC/", emu_info.path);
+	u32 base_len = strlen(path);
+
+	timer = get_tmr_s();
+
+	// BOOT0, BOOT1 and then all GPP parts.
+	for (int i = -2; i < 100; i++)
+	{
+		if (i < 0)
+			s_printf(path + base_len, "BOOT%d", i + 2);
+		else
+			update_emummc_base_folder(path, base_len, i);
+
+		if (f_stat(path, NULL))
+			break;
+
+		u32 file_extents = _emummc_file_extents(path);
+		parts++;
+		extents += file_extents;
+
+		s_printf(txt_buf, "%s: %d fragmento%s... ", path + base_len, file_extents, file_extents == 1 ? "" : "s");
+		lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, txt_buf);
+		manual_system_maintenance(true);
+
+		if (file_extents <= 1)
+		{
+			lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, "OK\n");
+			continue;
+		}
+
+		res = _defrag_emummc_file_part(gui, path);
+		if (!res)
+		{
+			lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, "#FFDD00 Fallo!#\n");
+			break;
+		}
+
+		lv_label_ins_text(gui->label_log, LV_LABEL_POS_LAST, "Hecho!\n");
+		manual_system_maintenance(true);
+	}
+
+	timer = get_tmr_s() - timer;
+
+	if (res)
+		s_printf(txt_buf, "%d archivos, %d fragmentos.\nTiempo: %dm %ds.\nFinalizado!", parts, extents, timer / 60, timer % 60);
+	else
+		s_printf(txt_buf, "Tiempo: %dm %ds.", timer / 60, timer % 60);
+	lv_label_set_text(gui->label_finish, txt_buf);
+
+out_cfg:
+	free(emu_info.path);
+	free(emu_info.nintendo_path);
+out:
+	free(path);
+	free(txt_buf);
+	sd_unmount();
+}
+
 static int _dump_emummc_raw_part(emmc_tool_gui_t *gui, int active_part, int part_idx, u32 sd_part_off, emmc_part_t *part, u32 resized_count)
 {
 	u32 num = 0;
-	u32 pct = 0;
-	u32 prevPct = 200;
 	int retryCount = 0;
 	u32 sd_sector_off = sd_part_off + (0x2000 * active_part);
+	gui_progress_t prog;
 	u32 lba_curr = part->lba_start;
 	u8 *buf = (u8 *)MIXD_BUF_ALIGNED;
 
@@ -555,6 +815,7 @@ static int _dump_emummc_raw_part(emmc_tool_gui_t *gui, int active_part, int part
 	}
 
 	u32 totalSectors = part->lba_end - part->lba_start + 1;
+	gui_progress_init(&prog, gui->bar, gui->label_pct, part->lba_end - part->lba_start);
 	while (totalSectors > 0)
 	{
 		// Check for cancellation combo.
@@ -629,25 +890,12 @@ static int _dump_emummc_raw_part(emmc_tool_gui_t *gui, int active_part, int part
 			}
 		}
 
-		manual_system_maintenance(false);
-
-		pct = (u64)((u64)(lba_curr - part->lba_start) * 100u) / (u64)(part->lba_end - part->lba_start);
-		if (pct != prevPct)
-		{
-			lv_bar_set_value(gui->bar, pct);
-			s_printf(gui->txt_buf, " "SYMBOL_DOT" %d%%", pct);
-			lv_label_set_text(gui->label_pct, gui->txt_buf);
-			manual_system_maintenance(true);
-
-			prevPct = pct;
-		}
+		gui_progress_post(&prog, lba_curr - part->lba_start);
 
 		lba_curr += num;
 		totalSectors -= num;
 	}
-	lv_bar_set_value(gui->bar, 100);
-	lv_label_set_text(gui->label_pct, " "SYMBOL_DOT" 100%");
-	manual_system_maintenance(true);
+	gui_progress_done(&prog);
 
 	// Set partition type to emuMMC (0xE0).
 	if (active_part == 2)
@@ -23,6 +23,8 @@
 #include "gui_tools.h"
 #include "gui_info.h"
 #include "gui_options.h"
+#include "gui_img_cache.h"
+#include "gui_res.h"
 #include <libs/lvgl/lv_themes/lv_theme_hekate.h>
 #include <libs/lvgl/lvgl.h>
 #include "../gfx/logos-gui.h"
@@ -310,14 +312,66 @@ static void _save_fb_to_bmp()
 	timer = get_tmr_ms() + 2000;
 }
 
+// Damaged area of the intermediate framebuffer since last composition.
+#define DISP_CPU_ROT_MAX_PX (64 * 64)
+static lv_area_t disp_damage;
+static bool disp_damaged = false;
+static bool disp_refreshed = false;
+
+static void _disp_fb_rotate_rect(const lv_area_t *area)
+{
+	u32 *src = (u32 *)NYX_FB2_ADDRESS;
+	u32 *dst = (u32 *)NYX_FB_ADDRESS;
+
+	// Same mapping as VIC 270 rotation. Output lines are written sequentially.
+	for (u32 x = area->x1; x <= (u32)area->x2; x++)
+	{
+		u32 *out = &dst[(1279 - x) * 720];
+		for (u32 y = area->y1; y <= (u32)area->y2; y++)
+			out[y] = src[x + y * 1280];
+	}
+}
+
+static void _disp_fb_refresh_done(uint32_t time, uint32_t px_num)
+{
+	disp_refreshed = true;
+
+	if (!disp_damaged)
+		return;
+
+	disp_damaged = false;
+
+	// Rotate small areas directly. VIC setup costs more than that.
+	if (lv_area_get_size(&disp_damage) <= DISP_CPU_ROT_MAX_PX)
+	{
+		vic_wait_idle();
+		_disp_fb_rotate_rect(&disp_damage);
+
+		// Flush rotated pixels to DRAM so display scans out the new data.
+		bpmp_mmu_maintenance(BPMP_MMU_MAINT_CLEAN_WAY, false);
+		return;
+	}
+
+	// Align to surface cache width (64B) and rotate only the damaged area.
+	vic_compose_rect(ALIGN_DOWN(disp_damage.x1, 16), disp_damage.y1,
+					 ALIGN(disp_damage.x2 + 1, 16) - 1, disp_damage.y2);
+}
+
 static void _disp_fb_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t *color_p)
 {
 	// Draw to intermediate non-rotated framebuffer.
 	gfx_set_rect_pitch((u32 *)NYX_FB2_ADDRESS, (u32 *)color_p, 1280, x1, y1, x2, y2);
 
-	// Rotate and copy to visible framebuffer.
+	// Accumulate damage. Rotation and copy to visible framebuffer happen once at the end of refresh.
 	if (disp_init_done)
-		vic_compose();
+	{
+		lv_area_t area = { x1, y1, x2, y2 };
+		if (disp_damaged)
+			lv_area_join(&disp_damage, &disp_damage, &area);
+		else
+			lv_area_copy(&disp_damage, &area);
+		disp_damaged = true;
+	}
 
 	// Check if display init was done. If it's the first big draw, init.
 	if (!disp_init_done && ((x2 - x1 + 1) > 600))
@@ -693,49 +747,39 @@ lv_img_dsc_t *bmp_to_lvimg_obj(const char *path)
 			flipped = true;
 		}
 
-		lv_img_dsc_t *img_desc = (lv_img_dsc_t *)bitmap;
-		u32 offset_copy = ALIGN((u32)bitmap + sizeof(lv_img_dsc_t), 0x10);
+		u32 data_size = bmpData.size - bmpData.offset;
+		u32 row_size = bmpData.size_x * sizeof(u32);
+		if ((u64)row_size * bmpData.size_y > data_size)
+			goto out;
+
+		u32 hdr_size = ALIGN(sizeof(lv_img_dsc_t), 0x10);
+		lv_img_dsc_t *img_desc = (lv_img_dsc_t *)malloc(hdr_size + data_size);
 
 		img_desc->header.always_zero = 0;
 		img_desc->header.w = bmpData.size_x;
 		img_desc->header.h = bmpData.size_y;
 		img_desc->header.cf = (bitmap[28] == 32) ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
-		img_desc->data_size = bmpData.size - bmpData.offset;
-		img_desc->data = (u8 *)offset_copy;
-
-		u32 *tmp = malloc(bmpData.size);
-		u32 *tmp2 = (u32 *)offset_copy;
+		img_desc->data_size = data_size;
+		img_desc->data = (u8 *)img_desc + hdr_size;
 
-		// Copy the unaligned data to an aligned buffer.
-		memcpy((u8 *)tmp, bitmap + bmpData.offset, img_desc->data_size);
-		u32 j = 0;
-
-		if (!flipped)
+		// Copy rows to the aligned buffer and flip them if default Bottom-Top.
+		u8 *src = bitmap + bmpData.offset;
+		u8 *dst = (u8 *)img_desc->data;
+		for (u32 y = 0; y < bmpData.size_y; y++)
 		{
-			for (u32 y = 0; y < bmpData.size_y; y++)
-			{
-				for (u32 x = 0; x < bmpData.size_x; x++)
-					tmp2[j++] = tmp[(bmpData.size_y - 1 - y ) * bmpData.size_x + x];
-			}
-		}
-		else
-		{
-			for (u32 y = 0; y < bmpData.size_y; y++)
-			{
-				for (u32 x = 0; x < bmpData.size_x; x++)
-					tmp2[j++] = tmp[y * bmpData.size_x + x];
-			}
+			u32 src_y = flipped ? y : (bmpData.size_y - 1 - y);
+			memcpy(dst + y * row_size, src + src_y * row_size, row_size);
 		}
 
-		free(tmp);
-	}
-	else
-	{
 		free(bitmap);
-		return NULL;
+
+		return img_desc;
 	}
 
-	return (lv_img_dsc_t *)bitmap;
+out:
+	free(bitmap);
+
+	return NULL;
 }
 
 lv_res_t nyx_generic_onoff_toggle(lv_obj_t *btn)
@@ -1291,6 +1335,9 @@ static void _create_tab_about(lv_theme_t * th, lv_obj_t * parent)
 		"#00CCFF               `      '-;         (-'#"
 	);
 
+	gui_res_load_img(&hekate_logo);
+	gui_res_load_img(&ctcaer_logo);
+
 	lv_obj_t *hekate_img = lv_img_create(parent, NULL);
 	lv_img_set_src(hekate_img, &hekate_logo);
 	lv_obj_align(hekate_img, lbl_octopus, LV_ALIGN_OUT_BOTTOM_LEFT, 0, LV_DPI * 2 / 3);
@@ -1457,25 +1504,7 @@ static lv_res_t _launch_more_cfg_action(lv_obj_t *btn)
 
 static lv_res_t _win_launch_close_action(lv_obj_t * btn)
 {
-	// Cleanup icons.
-	for (u32 i = 0; i < 8; i++)
-	{
-		lv_obj_t *btn = launch_ctxt.btn[i];
-		lv_btn_ext_t *ext = lv_obj_get_ext_attr(btn);
-		if (ext->idx)
-		{
-			// This gets latest object, which is the button overlay. So iterate 2 times.
-			lv_obj_t * img = lv_obj_get_child(btn, NULL);
-			img = lv_obj_get_child(btn, img);
-
-			lv_img_dsc_t *src = (lv_img_dsc_t *)lv_img_get_src(img);
-
-			// Avoid freeing base icons.
-			if ((src != icon_switch) && (src != icon_payload))
-				free(src);
-		}
-	}
-
+	// Icons are owned by the image cache.
 	lv_obj_t * win = lv_win_get_from_btn(btn);
 
 	lv_obj_del(win);
@@ -1720,22 +1749,31 @@ static lv_res_t _create_window_home_launch(lv_obj_t *btn)
 	if (!sd_mount())
 		goto failed_sd_mount;
 
+	// Free icons of previous launch windows if over budget.
+	gui_img_cache_trim();
+
 	// Check if we use custom system icons.
 	bool icon_sw_custom = !f_stat("bootloader/res/icon_switch_custom.bmp", NULL);
 	bool icon_pl_custom = !f_stat("bootloader/res/icon_payload_custom.bmp", NULL);
 
+	// Load default launch icons if not already.
+	if (!icon_switch)
+		icon_switch = bmp_to_lvimg_obj(icon_sw_custom ? "bootloader/res/icon_switch_custom.bmp" : "bootloader/res/icon_switch.bmp");
+	if (!icon_payload)
+		icon_payload = bmp_to_lvimg_obj(icon_pl_custom ? "bootloader/res/icon_payload_custom.bmp" : "bootloader/res/icon_payload.bmp");
+
 	// Choose what to parse.
 	bool ini_parse_success = false;
 	if (!more_cfg)
-		ini_parse_success = ini_parse(&ini_sections, "bootloader/hekate_ipl.ini", false);
+		ini_parse_success = ini_parse_cached(&ini_sections, "bootloader/hekate_ipl.ini", false, INI_CACHE_IPL);
 	else
-		ini_parse_success = ini_parse(&ini_sections, "bootloader/ini", true);
+		ini_parse_success = ini_parse_cached(&ini_sections, "bootloader/ini", true, INI_CACHE_INI_DIR);
 
 	if (combined_cfg && !ini_parse_success)
 	{
 ini_parsing:
 		list_init(&ini_sections);
-		ini_parse_success = ini_parse(&ini_sections, "bootloader/ini", true);
+		ini_parse_success = ini_parse_cached(&ini_sections, "bootloader/ini", true, INI_CACHE_INI_DIR);
 		more_cfg = true;
 	}
 
@@ -1770,11 +1808,11 @@ ini_parsing:
 		if (!icon_path)
 		{
 			s_printf(tmp_path, "bootloader/res/%s.bmp", ini_sec->name);
-			bmp = bmp_to_lvimg_obj(tmp_path);
+			bmp = gui_img_cache_get(tmp_path);
 			if (!bmp)
 			{
 				s_printf(tmp_path, "bootloader/res/%s_hue_nobox.bmp", ini_sec->name);
-				bmp = bmp_to_lvimg_obj(tmp_path);
+				bmp = gui_img_cache_get(tmp_path);
 				if (bmp)
 				{
 					img_noborder = true;
@@ -1783,14 +1821,14 @@ ini_parsing:
 				if (!bmp)
 				{
 					s_printf(tmp_path, "bootloader/res/%s_hue.bmp", ini_sec->name);
-					bmp = bmp_to_lvimg_obj(tmp_path);
+					bmp = gui_img_cache_get(tmp_path);
 					if (bmp)
 						img_colorize = true;
 				}
 				if (!bmp)
 				{
 					s_printf(tmp_path, "bootloader/res/%s_nobox.bmp", ini_sec->name);
-					bmp = bmp_to_lvimg_obj(tmp_path);
+					bmp = gui_img_cache_get(tmp_path);
 					if (bmp)
 						img_noborder = true;
 				}
@@ -1806,7 +1844,7 @@ ini_parsing:
 		}
 		else
 		{
-			bmp = bmp_to_lvimg_obj(icon_path);
+			bmp = gui_img_cache_get(icon_path);
 
 			// Check if both colorization and border are enabled.
 			if (bmp && strlen(icon_path) > 14 && !memcmp(icon_path + strlen(icon_path) - 14, "_hue_nobox", 10))
@@ -2411,6 +2449,92 @@ static void _nyx_main_menu(lv_theme_t * th)
 		task_bpmp_clock = lv_task_create(first_time_bpmp_clock, 10000, LV_TASK_PRIO_LOWEST, NULL);
 }
 
+// DRAM frequency governor.
+#define DVFS_INPUT_ACTIVE_MS 100
+#define DVFS_MC_LOAD_HIGH    100 // 10.0%.
+
+static struct _dvfs_ctxt_t
+{
+	bool high;
+	u32 last_active;
+	u32 last_update;
+	u32 last_switch;
+	gui_dvfs_stats_t stats;
+} dvfs;
+
+static void _nyx_dvfs_init()
+{
+	actmon_init();
+	actmon_dev_enable(ACTMON_DEV_MC_ALL);
+
+	memset(&dvfs, 0, sizeof(dvfs));
+	dvfs.high = true;
+	dvfs.last_active = get_tmr_ms();
+	dvfs.last_update = dvfs.last_active;
+	dvfs.last_switch = dvfs.last_active;
+	minerva_change_freq(FREQ_1600);
+}
+
+static void _nyx_dvfs_account(u32 now)
+{
+	// Account residency.
+	if (dvfs.high)
+		dvfs.stats.high_ms += now - dvfs.last_update;
+	else
+		dvfs.stats.low_ms += now - dvfs.last_update;
+	dvfs.last_update = now;
+}
+
+static void _nyx_dvfs_switch(bool high, u32 now)
+{
+	if (high == dvfs.high)
+		return;
+
+	minerva_change_freq(high ? FREQ_1600 : FREQ_800); // Takes 295 us and 80 us.
+
+	// Periodic compensation only runs at max frequency. Catch up on drift right away after a long park.
+	if (high && (now - dvfs.last_switch) >= EMC_PERIODIC_TRAIN_MS)
+		minerva_periodic_training();
+
+	dvfs.high = high;
+	dvfs.last_switch = now;
+	dvfs.stats.switches++;
+}
+
+void nyx_dvfs_set_high(bool high)
+{
+	u32 now = get_tmr_ms();
+
+	_nyx_dvfs_account(now);
+	_nyx_dvfs_switch(high, now);
+
+	// Don't let the governor drop it right away.
+	if (high)
+		dvfs.last_active = now;
+}
+
+static void _nyx_dvfs_update(bool busy)
+{
+	u32 now = get_tmr_ms();
+
+	_nyx_dvfs_account(now);
+
+	// Pending redraws, recent input or DRAM bandwidth demand keep max frequency.
+	if (busy ||
+		lv_indev_get_inactive_time(NULL) < DVFS_INPUT_ACTIVE_MS ||
+		actmon_dev_get_load_avg(ACTMON_DEV_MC_ALL) > DVFS_MC_LOAD_HIGH)
+	{
+		dvfs.last_active = now;
+	}
+
+	_nyx_dvfs_switch(!n_cfg.dram_idle || (now - dvfs.last_active) < n_cfg.dram_idle, now);
+}
+
+void nyx_dvfs_get_stats(gui_dvfs_stats_t *stats)
+{
+	memcpy(stats, &dvfs.stats, sizeof(gui_dvfs_stats_t));
+}
+
 void nyx_load_and_run()
 {
 	memset(&system_tasks, 0, sizeof(system_maintenance_tasks_t));
@@ -2423,6 +2547,7 @@ void nyx_load_and_run()
 	lv_disp_drv_init(&disp_drv);
 	disp_drv.disp_flush = _disp_fb_flush;
 	lv_disp_drv_register(&disp_drv);
+	lv_refr_set_monitor_cb(_disp_fb_refresh_done);
 
 	// Initialize Joy-Con.
 	if (!n_cfg.jc_disable)
@@ -2455,7 +2580,9 @@ void nyx_load_and_run()
 	lv_theme_set_current(th);
 
 	// Create main menu
+	TRACE_BEGIN("nyx_main_menu");
 	_nyx_main_menu(th);
+	TRACE_END("nyx_main_menu");
 
 	jc_drv_ctx.cursor = lv_img_create(lv_scr_act(), NULL);
 	lv_img_set_src(jc_drv_ctx.cursor, &touch_cursor);
@@ -2469,6 +2596,17 @@ void nyx_load_and_run()
 		lv_task_once(task_run_sd_errors);
 	}
 
+#ifdef BDK_TRACE_ENABLE
+	// Render first frame and save boot trace.
+	TRACE_BEGIN("first_frame");
+	lv_refr_now();
+	TRACE_END("first_frame");
+	TRACE_EXPORT("bootloader/trace.json");
+#endif
+
+	// Page in the rest of the resources in the background.
+	gui_res_start_paging();
+
 	// Gui loop.
 	if (h_cfg.t210b01)
 	{
@@ -2478,14 +2616,16 @@ void nyx_load_and_run()
 	}
 	else
 	{
-		// Alternate DRAM frequencies. Saves 280 mW.
+		// Scale DRAM frequency based on GUI activity. Saves 280 mW when idle.
+		_nyx_dvfs_init();
 		while (true)
 		{
-			minerva_change_freq(FREQ_1600);  // Takes 295 us.
+			_nyx_dvfs_update(lv_refr_get_buf_size() != 0);
 
 			lv_task_handler();
 
-			minerva_change_freq(FREQ_800);   // Takes 80 us.
+			_nyx_dvfs_update(disp_refreshed);
+			disp_refreshed = false;
 		}
 	}
 }
@@ -44,6 +44,13 @@ typedef struct _gui_status_bar_ctx
 	lv_obj_t *battery_more;
 } gui_status_bar_ctx;
 
+typedef struct _gui_dvfs_stats_t
+{
+	u32 switches;
+	u32 high_ms; // Residency at 1600 MHz.
+	u32 low_ms;  // Residency at 800 MHz.
+} gui_dvfs_stats_t;
+
 extern lv_style_t hint_small_style;
 extern lv_style_t hint_small_style_white;
 extern lv_style_t monospace_text;
@@ -78,6 +85,8 @@ lv_obj_t *nyx_create_window_custom_close_btn(const char *win_title, lv_action_t
 void nyx_create_onoff_button(lv_theme_t *th, lv_obj_t *parent, lv_obj_t *btn, const char *btn_name, lv_action_t action, bool transparent);
 lv_res_t nyx_generic_onoff_toggle(lv_obj_t *btn);
 void manual_system_maintenance(bool refresh);
+void nyx_dvfs_set_high(bool high);
+void nyx_dvfs_get_stats(gui_dvfs_stats_t *stats);
 void nyx_load_and_run();
 
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022 CTCaer
+ * Copyright (c) 2019-2026 CTCaer
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -52,12 +52,14 @@ static lv_res_t _action_emummc_window_close(lv_obj_t *btn)
 	return LV_RES_INV;
 }
 
-static void _create_window_emummc()
+static void _create_window_emummc(bool defrag)
 {
 	emmc_tool_gui_t emmc_tool_gui_ctxt;
 
 	lv_obj_t *win;
-	if (!mbr_ctx.part_idx)
+	if (defrag)
+		win = nyx_create_window_custom_close_btn(SYMBOL_SHUFFLE"  Desfragmentar Archivo SD EmuNAND", _action_emummc_window_close);
+	else if (!mbr_ctx.part_idx)
 		win = nyx_create_window_custom_close_btn(SYMBOL_DRIVE"  Crear Archivo SD EmuNAND", _action_emummc_window_close);
 	else
 		win = nyx_create_window_custom_close_btn(SYMBOL_DRIVE"  Crear Particion SD EmuNAND", _action_emummc_window_close);
@@ -132,7 +134,9 @@ static void _create_window_emummc()
 	lv_obj_align(label_finish, bar, LV_ALIGN_OUT_BOTTOM_LEFT, 0, LV_DPI * 9 / 20);
 	emmc_tool_gui_ctxt.label_finish = label_finish;
 
-	if (!mbr_ctx.part_idx)
+	if (defrag)
+		defrag_emummc_file(&emmc_tool_gui_ctxt);
+	else if (!mbr_ctx.part_idx)
 		dump_emummc_file(&emmc_tool_gui_ctxt);
 	else
 		dump_emummc_raw(&emmc_tool_gui_ctxt, mbr_ctx.part_idx, mbr_ctx.sector_start, mbr_ctx.resized_cnt[mbr_ctx.part_idx - 1]);
@@ -185,7 +189,7 @@ static lv_res_t _create_emummc_raw_action(lv_obj_t * btns, const char * txt)
 	if (btn_idx < 3)
 	{
 		lv_obj_set_style(bg, &lv_style_transp);
-		_create_window_emummc();
+		_create_window_emummc(false);
 	}
 
 	mbr_ctx.part_idx = 0;
@@ -322,7 +326,7 @@ static lv_res_t _create_emummc_action(lv_obj_t * btns, const char * txt)
 	{
 	case 0:
 		lv_obj_set_style(bg, &lv_style_transp);
-		_create_window_emummc();
+		_create_window_emummc(false);
 		break;
 	case 1:
 		_create_mbox_emummc_raw();
@@ -362,6 +366,50 @@ static lv_res_t _create_mbox_emummc_create(lv_obj_t *btn)
 	return LV_RES_OK;
 }
 
+static lv_res_t _create_emummc_defrag_action(lv_obj_t * btns, const char * txt)
+{
+	int btn_idx = lv_btnm_get_pressed(btns);
+	lv_obj_t *bg = lv_obj_get_parent(lv_obj_get_parent(btns));
+
+	if (!btn_idx)
+	{
+		lv_obj_set_style(bg, &lv_style_transp);
+		_create_window_emummc(true);
+	}
+
+	mbox_action(btns, txt);
+
+	return LV_RES_INV;
+}
+
+static lv_res_t _create_mbox_emummc_defrag(lv_obj_t *btn)
+{
+	if (!nyx_emmc_check_battery_enough())
+		return LV_RES_OK;
+
+	lv_obj_t *dark_bg = lv_obj_create(lv_scr_act(), NULL);
+	lv_obj_set_style(dark_bg, &mbox_darken);
+	lv_obj_set_size(dark_bg, LV_HOR_RES, LV_VER_RES);
+
+	static const char * mbox_btn_map[] = { "\222Continuar", "\222Cancelar", "" };
+	lv_obj_t * mbox = lv_mbox_create(dark_bg, NULL);
+	lv_mbox_set_recolor_text(mbox, true);
+	lv_obj_set_width(mbox, LV_HOR_RES / 9 * 6);
+
+	lv_mbox_set_text(mbox,
+		"Se comprobaran los fragmentos de cada archivo de la\n"
+		"#C7EA46 EmuNAND# activa y se reescribiran de forma contigua.\n\n"
+		"Cada archivo fragmentado necesita su tamano en espacio\n"
+		"#FF8000 contiguo# libre en la SD.");
+
+	lv_mbox_add_btns(mbox, mbox_btn_map, _create_emummc_defrag_action);
+
+	lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
+	lv_obj_set_top(mbox, true);
+
+	return LV_RES_OK;
+}
+
 static void _change_raw_emummc_part_type()
 {
 	mbr_t *mbr = (mbr_t *)malloc(sizeof(mbr_t));
@@ -1314,5 +1362,19 @@ lv_res_t create_win_emummc_tools(lv_obj_t *btn)
 	lv_obj_set_style(label_txt4, &hint_small_style);
 	lv_obj_align(label_txt4, btn4, LV_ALIGN_OUT_BOTTOM_LEFT, 0, LV_DPI / 3);
 
+	// Create Defrag emuMMC button.
+	lv_obj_t *btn5 = lv_btn_create(h2, btn2);
+	label_btn = lv_label_create(btn5, NULL);
+	lv_label_set_static_text(label_btn, SYMBOL_SHUFFLE"  Desfragmentar");
+	lv_obj_align(btn5, label_txt4, LV_ALIGN_OUT_BOTTOM_LEFT, 0, LV_DPI / 2);
+	lv_btn_set_action(btn5, LV_BTN_ACTION_CLICK, _create_mbox_emummc_defrag);
+
+	label_txt4 = lv_label_create(h2, NULL);
+	lv_label_set_recolor(label_txt4, true);
+	lv_label_set_static_text(label_txt4,
+		"Reescribe de forma contigua los archivos de una #C7EA46 Archivo SD#.");
+	lv_obj_set_style(label_txt4, &hint_small_style);
+	lv_obj_align(label_txt4, btn5, LV_ALIGN_OUT_BOTTOM_LEFT, 0, LV_DPI / 3);
+
 	return LV_RES_OK;
 }
@@ -0,0 +1,264 @@
+/*
+ * Nyx decoded image cache
+ *
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <bdk.h>
+
+#include <libs/compr/lz4.h>
+#include <libs/fatfs/ff.h>
+
+#include "gui.h"
+#include "gui_img_cache.h"
+
+#define IMG_CACHE_ENTRIES 32
+#define IMG_CACHE_BUDGET  SZ_8M
+
+typedef struct _img_cache_entry_t
+{
+	char *path;
+	u32 src_size;
+	u32 src_time;
+	u32 size;
+	u32 last_use;
+	lv_img_dsc_t *img;
+} img_cache_entry_t;
+
+static img_cache_entry_t _img_cache[IMG_CACHE_ENTRIES];
+static u32 _img_cache_tick = 0;
+
+static void _img_cache_entry_free(img_cache_entry_t *entry)
+{
+	free(entry->path);
+	free(entry->img);
+	memset(entry, 0, sizeof(img_cache_entry_t));
+}
+
+static void _img_cache_file_path(char *cache_path, u32 path_crc32)
+{
+	s_printf(cache_path, IMG_CACHE_DIR"/%08X.bin", path_crc32);
+}
+
+static lv_img_dsc_t *_img_cache_sd_load(u32 path_crc32, u32 src_size, u32 src_time)
+{
+	char cache_path[40];
+	_img_cache_file_path(cache_path, path_crc32);
+
+	u32 fsize;
+	img_cache_hdr_t *hdr = (img_cache_hdr_t *)sd_file_read(cache_path, &fsize);
+	if (!hdr)
+		return NULL;
+
+	lv_img_dsc_t *img = NULL;
+	if (fsize < sizeof(img_cache_hdr_t)                 ||
+		hdr->magic != IMG_CACHE_MAGIC                   ||
+		hdr->version != IMG_CACHE_VERSION               ||
+		hdr->path_crc32 != path_crc32                   ||
+		hdr->src_size != src_size                       ||
+		hdr->src_time != src_time                       ||
+		hdr->csize > hdr->data_size                     ||
+		fsize != sizeof(img_cache_hdr_t) + hdr->csize)
+		goto out;
+
+	// Same layout as bmp_to_lvimg_obj.
+	u32 hdr_size = ALIGN(sizeof(lv_img_dsc_t), 0x10);
+	img = (lv_img_dsc_t *)malloc(hdr_size + hdr->data_size);
+	memcpy(&img->header, &hdr->header, sizeof(lv_img_header_t));
+	img->data_size = hdr->data_size;
+	img->data = (u8 *)img + hdr_size;
+
+	u8 *cdata = (u8 *)hdr + sizeof(img_cache_hdr_t);
+	if (hdr->csize == hdr->data_size)
+		memcpy((u8 *)img->data, cdata, hdr->data_size);
+	else if (LZ4_decompress_safe((const char *)cdata, (char *)img->data, hdr->csize, hdr->data_size) != (int)hdr->data_size)
+	{
+		free(img);
+		img = NULL;
+	}
+
+out:
+	free(hdr);
+
+	return img;
+}
+
+static void _img_cache_sd_save(const lv_img_dsc_t *img, u32 path_crc32, u32 src_size, u32 src_time)
+{
+	u32 bound = LZ4_compressBound(img->data_size);
+	img_cache_hdr_t *hdr = (img_cache_hdr_t *)malloc(sizeof(img_cache_hdr_t) + bound);
+	u8 *cdata = (u8 *)hdr + sizeof(img_cache_hdr_t);
+
+	hdr->magic      = IMG_CACHE_MAGIC;
+	hdr->version    = IMG_CACHE_VERSION;
+	hdr->path_crc32 = path_crc32;
+	hdr->src_size   = src_size;
+	hdr->src_time   = src_time;
+	memcpy(&hdr->header, &img->header, sizeof(lv_img_header_t));
+	hdr->data_size  = img->data_size;
+
+	// Store it if it does not compress.
+	int csize = LZ4_compress_default((const char *)img->data, (char *)cdata, img->data_size, bound);
+	if (csize <= 0 || (u32)csize >= img->data_size)
+	{
+		memcpy(cdata, img->data, img->data_size);
+		csize = img->data_size;
+	}
+	hdr->csize = csize;
+
+	char cache_path[40];
+	_img_cache_file_path(cache_path, path_crc32);
+
+	f_mkdir(IMG_CACHE_DIR);
+	sd_save_to_file(hdr, sizeof(img_cache_hdr_t) + csize, cache_path);
+
+	free(hdr);
+}
+
+static bool _img_cache_src_stat(const char *path, u32 *src_size, u32 *src_time)
+{
+	// Only directory metadata is read. The BMP itself is read only on a full miss.
+	FILINFO fno;
+	if (f_stat(path, &fno))
+		return false;
+
+	*src_size = fno.fsize;
+	*src_time = (fno.fdate << 16) | fno.ftime;
+
+	return true;
+}
+
+static lv_img_dsc_t *_img_cache_decode(const char *path, u32 src_size, u32 src_time)
+{
+	// Check SD cache, otherwise decode the BMP and save it.
+	u32 path_crc32 = crc32_calc(0, (const u8 *)path, strlen(path));
+	lv_img_dsc_t *img = _img_cache_sd_load(path_crc32, src_size, src_time);
+	if (!img)
+	{
+		img = bmp_to_lvimg_obj(path);
+		if (img)
+			_img_cache_sd_save(img, path_crc32, src_size, src_time);
+	}
+
+	return img;
+}
+
+/*
+ * Returns the image for a BMP path. SD must be mounted.
+ * Images are owned by the cache and stay valid until gui_img_cache_trim().
+ */
+lv_img_dsc_t *gui_img_cache_get(const char *path)
+{
+	u32 src_size, src_time;
+	if (!_img_cache_src_stat(path, &src_size, &src_time))
+		return NULL;
+
+	// Check memory cache.
+	img_cache_entry_t *free_entry = NULL;
+	img_cache_entry_t *lru_entry = &_img_cache[0];
+	for (u32 i = 0; i < IMG_CACHE_ENTRIES; i++)
+	{
+		img_cache_entry_t *entry = &_img_cache[i];
+		if (!entry->path)
+		{
+			if (!free_entry)
+				free_entry = entry;
+			continue;
+		}
+
+		if (!strcmp(entry->path, path))
+		{
+			if (entry->src_size == src_size && entry->src_time == src_time)
+			{
+				entry->last_use = ++_img_cache_tick;
+				return entry->img;
+			}
+
+			// Source changed.
+			_img_cache_entry_free(entry);
+			if (!free_entry)
+				free_entry = entry;
+			continue;
+		}
+
+		if (entry->last_use < lru_entry->last_use)
+			lru_entry = entry;
+	}
+
+	lv_img_dsc_t *img = _img_cache_decode(path, src_size, src_time);
+	if (!img)
+		return NULL;
+
+	// Insert it. Evict least recently used if full.
+	img_cache_entry_t *entry = free_entry;
+	if (!entry)
+	{
+		entry = lru_entry;
+		_img_cache_entry_free(entry);
+	}
+
+	entry->path     = malloc(strlen(path) + 1);
+	strcpy(entry->path, path);
+	entry->src_size = src_size;
+	entry->src_time = src_time;
+	entry->size     = ALIGN(sizeof(lv_img_dsc_t), 0x10) + img->data_size;
+	entry->last_use = ++_img_cache_tick;
+	entry->img      = img;
+
+	return img;
+}
+
+/*
+ * Returns the image for a BMP path through the SD cache only. SD must be mounted.
+ * The caller owns the image, same as bmp_to_lvimg_obj(). For images that stay resident.
+ */
+lv_img_dsc_t *gui_img_cache_load(const char *path)
+{
+	u32 src_size, src_time;
+	if (!_img_cache_src_stat(path, &src_size, &src_time))
+		return NULL;
+
+	return _img_cache_decode(path, src_size, src_time);
+}
+
+/*
+ * Evicts least recently used images until the cache fits its budget.
+ * Must not be called while cached images are displayed.
+ */
+void gui_img_cache_trim()
+{
+	while (true)
+	{
+		u32 total = 0;
+		img_cache_entry_t *lru_entry = NULL;
+		for (u32 i = 0; i < IMG_CACHE_ENTRIES; i++)
+		{
+			img_cache_entry_t *entry = &_img_cache[i];
+			if (!entry->path)
+				continue;
+
+			total += entry->size;
+			if (!lru_entry || entry->last_use < lru_entry->last_use)
+				lru_entry = entry;
+		}
+
+		if (total <= IMG_CACHE_BUDGET)
+			break;
+
+		_img_cache_entry_free(lru_entry);
+	}
+}
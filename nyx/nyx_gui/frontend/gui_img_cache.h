@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GUI_IMG_CACHE_H_
+#define _GUI_IMG_CACHE_H_
+
+#include <libs/lvgl/lvgl.h>
+#include <utils/types.h>
+
+#define IMG_CACHE_DIR     "bootloader/sys/icons"
+#define IMG_CACHE_MAGIC   0x434F4349 // "ICOC".
+#define IMG_CACHE_VERSION 3
+
+typedef struct _img_cache_hdr_t
+{
+	u32 magic;
+	u32 version;
+	u32 path_crc32;
+	u32 src_size;
+	u32 src_time;  // FAT date << 16 | time.
+	u32 header;    // lv_img_header_t.
+	u32 data_size;
+	u32 csize;     // LZ4 size. Equal to data_size if stored.
+} img_cache_hdr_t;
+
+lv_img_dsc_t *gui_img_cache_get(const char *path);
+lv_img_dsc_t *gui_img_cache_load(const char *path);
+void gui_img_cache_trim();
+
+#endif
@@ -19,6 +19,7 @@
 #include <bdk.h>
 
 #include "gui.h"
+#include "gui_progress.h"
 #include "../config.h"
 #include "../hos/hos.h"
 #include "../hos/pkg1.h"
@@ -814,6 +815,16 @@ static lv_res_t _create_window_fuses_info_status(lv_obj_t *btn)
 		s_printf(txt_buf + strlen(txt_buf), " x Des (%d)", (ram_density.rank0_ch1 & 0x3C) >> 2);
 		break;
 	}
+
+	// DRAM frequency residency.
+	gui_dvfs_stats_t dvfs_stats;
+	nyx_dvfs_get_stats(&dvfs_stats);
+	u32 dvfs_total = dvfs_stats.high_ms + dvfs_stats.low_ms;
+	if (dvfs_total)
+	{
+		s_printf(txt_buf + strlen(txt_buf), "\n#FF8000 Residencia:# 1600MHz %d%% #FF8000 |# 800MHz %d%% (%d cambios)",
+			(u32)((u64)dvfs_stats.high_ms * 100 / dvfs_total), (u32)((u64)dvfs_stats.low_ms * 100 / dvfs_total), dvfs_stats.switches);
+	}
 	strcat(txt_buf, "\n\n");
 
 	// Prepare display info.
@@ -1351,6 +1362,7 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 	manual_system_maintenance(true);
 
 	int res = 0;
+	u32 init_time = get_tmr_us();
 
 	if (sd_bench)
 	{
@@ -1367,6 +1379,7 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 		if (!res)
 			emmc_set_partition(EMMC_GPP);
 	}
+	init_time = get_tmr_us() - init_time;
 
 	if (res)
 	{
@@ -1374,6 +1387,10 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 		goto out;
 	}
 
+	// Show init latency and if a cached tuning profile was used.
+	s_printf(txt_buf, "Inicio: #C7EA46 %d.%02d ms# (%s)\n",
+		init_time / 1000, (init_time % 1000) / 10, storage->tuning_cached ? "perfil en cache" : "tuning completo");
+
 	int error = 0;
 	u32 iters = 3;
 	u32 offset_chunk_start = ALIGN_DOWN(storage->sec_cnt / 3, 0x8000); // Align to 16MB.
@@ -1382,18 +1399,16 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 
 	for (u32 iter_curr = 0; iter_curr < iters; iter_curr++)
 	{
-		u32 pct = 0;
-		u32 prevPct = 200;
 		u32 timer = 0;
 		u32 lba_curr = 0;
 		u32 sector = offset_chunk_start * iter_curr;
 		u32 sector_num = 0x8000;       // 16MB chunks.
 		u32 data_remaining = 0x200000; // 1GB.
+		gui_progress_t prog;
 
 		s_printf(txt_buf + strlen(txt_buf), "#C7EA46 %d/3# - Offset Sector #C7EA46 %08X#:\n", iter_curr + 1, sector);
 
-		u32 render_min_ms = 66;
-		u32 render_timer  = get_tmr_ms() + render_min_ms;
+		gui_progress_init(&prog, bar, NULL, 0x200000);
 		while (data_remaining)
 		{
 			u32 time_taken = get_tmr_us();
@@ -1401,22 +1416,12 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 			time_taken = get_tmr_us() - time_taken;
 			timer += time_taken;
 
-			manual_system_maintenance(false);
 			data_remaining -= sector_num;
 			lba_curr += sector_num;
 
-			pct = (lba_curr * 100) / 0x200000;
-			if (pct != prevPct && render_timer < get_tmr_ms())
-			{
-				lv_bar_set_value(bar, pct);
-				manual_system_maintenance(true);
-				render_timer = get_tmr_ms() + render_min_ms;
-
-				prevPct = pct;
-
-				if (btn_read_vol() == (BTN_VOL_UP | BTN_VOL_DOWN))
-					error = -1;
-			}
+			// Check for cancellation on every rendered frame.
+			if (gui_progress_post(&prog, lba_curr) && btn_read_vol() == (BTN_VOL_UP | BTN_VOL_DOWN))
+				error = -1;
 
 			if (error)
 				goto error;
@@ -1432,14 +1437,12 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 		lv_obj_align(mbox, NULL, LV_ALIGN_CENTER, 0, 0);
 		manual_system_maintenance(true);
 
-		pct = 0;
-		prevPct = 200;
 		timer = 0;
 		lba_curr = 0;
 		sector_num = 8;            // 4KB chunks.
 		data_remaining = 0x100000; // 512MB.
 
-		render_timer = get_tmr_ms() + render_min_ms;
+		gui_progress_init(&prog, bar, NULL, 0x100000);
 		while (data_remaining)
 		{
 			u32 time_taken = get_tmr_us();
@@ -1447,22 +1450,12 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 			time_taken = get_tmr_us() - time_taken;
 			timer += time_taken;
 
-			manual_system_maintenance(false);
 			data_remaining -= sector_num;
 			lba_curr += sector_num;
 
-			pct = (lba_curr * 100) / 0x100000;
-			if (pct != prevPct && render_timer < get_tmr_ms())
-			{
-				lv_bar_set_value(bar, pct);
-				manual_system_maintenance(true);
-				render_timer = get_tmr_ms() + render_min_ms;
-
-				prevPct = pct;
-
-				if (btn_read_vol() == (BTN_VOL_UP | BTN_VOL_DOWN))
-					error = -1;
-			}
+			// Check for cancellation on every rendered frame.
+			if (gui_progress_post(&prog, lba_curr) && btn_read_vol() == (BTN_VOL_UP | BTN_VOL_DOWN))
+				error = -1;
 
 			if (error)
 				goto error;
@@ -1494,12 +1487,10 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 			random_offsets[i + 3] = random_numbers[3] % 0x100000;
 		}
 
-		pct = 0;
-		prevPct = 200;
 		timer = 0;
 		data_remaining = 0x100000; // 512MB.
 
-		render_timer = get_tmr_ms() + render_min_ms;
+		gui_progress_init(&prog, bar, NULL, 0x20000);
 		while (data_remaining)
 		{
 			u32 time_taken = get_tmr_us();
@@ -1507,22 +1498,12 @@ static lv_res_t _create_mbox_benchmark(bool sd_bench)
 			time_taken = get_tmr_us() - time_taken;
 			timer += time_taken;
 
-			manual_system_maintenance(false);
 			data_remaining -= sector_num;
 			lba_idx++;
 
-			pct = (lba_idx * 100) / 0x20000;
-			if (pct != prevPct && render_timer < get_tmr_ms())
-			{
-				lv_bar_set_value(bar, pct);
-				manual_system_maintenance(true);
-				render_timer = get_tmr_ms() + render_min_ms;
-
-				prevPct = pct;
-
-				if (btn_read_vol() == (BTN_VOL_UP | BTN_VOL_DOWN))
-					error = -1;
-			}
+			// Check for cancellation on every rendered frame.
+			if (gui_progress_post(&prog, lba_idx) && btn_read_vol() == (BTN_VOL_UP | BTN_VOL_DOWN))
+				error = -1;
 
 			if (error)
 			{
@@ -2153,7 +2134,8 @@ static lv_res_t _create_window_sdcard_info_status(lv_obj_t *btn)
 		"#00DDFF Errores SDMMC:#\n"
 		"Fallos Inicio:\n"
 		"Fallos Lect/Esc:\n"
-		"Errores Lect/Esc:"
+		"Errores Lect/Esc:\n"
+		"Errores x Modo:"
 	);
 	lv_obj_set_size(desc4, LV_HOR_RES / 2 / 5 * 2, LV_VER_RES - (LV_DPI * 11 / 8) * 4);
 	lv_obj_set_width(lb_desc4, lv_obj_get_width(desc4));
@@ -2165,10 +2147,16 @@ static lv_res_t _create_window_sdcard_info_status(lv_obj_t *btn)
 	lv_obj_t * lb_val4 = lv_label_create(val4, lb_desc);
 
 	u16 *sd_errors = sd_get_error_count();
-	s_printf(txt_buf, "\n%d (%d)\n%d (%d)\n%d (%d)",
+	u16 *sd_mode_errors = sd_get_mode_error_count();
+	s_printf(txt_buf, "\n%d (%d)\n%d (%d)\n%d (%d)\n%d/%d/%d/%d",
 		sd_errors[SD_ERROR_INIT_FAIL], nyx_str->info.sd_errors[SD_ERROR_INIT_FAIL],
 		sd_errors[SD_ERROR_RW_FAIL],   nyx_str->info.sd_errors[SD_ERROR_RW_FAIL],
-		sd_errors[SD_ERROR_RW_RETRY],  nyx_str->info.sd_errors[SD_ERROR_RW_RETRY]);
+		sd_errors[SD_ERROR_RW_RETRY],  nyx_str->info.sd_errors[SD_ERROR_RW_RETRY],
+		sd_mode_errors[SD_1BIT_HS25], sd_mode_errors[SD_4BIT_HS25], sd_mode_errors[SD_UHS_SDR82],
+		sd_mode_errors[SD_UHS_SDR104]);
+#ifdef BDK_SDMMC_UHS_DDR200_SUPPORT
+	s_printf(txt_buf + strlen(txt_buf), "/%d", sd_mode_errors[SD_UHS_DDR208]);
+#endif
 
 	lv_label_set_text(lb_val4, txt_buf);
 
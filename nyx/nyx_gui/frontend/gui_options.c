@@ -231,7 +231,7 @@ static void _create_autoboot_window()
 
 	// Parse hekate main configuration.
 	LIST_INIT(ini_sections);
-	if (ini_parse(&ini_sections, "bootloader/hekate_ipl.ini", false))
+	if (ini_parse_cached(&ini_sections, "bootloader/hekate_ipl.ini", false, INI_CACHE_IPL))
 	{
 		LIST_FOREACH_ENTRY(ini_sec_t, ini_sec, &ini_sections, link)
 		{
@@ -275,7 +275,7 @@ static void _create_autoboot_window()
 
 	// Parse all .ini files in ini folder.
 	LIST_INIT(ini_list_sections);
-	if (ini_parse(&ini_list_sections, "bootloader/ini", true))
+	if (ini_parse_cached(&ini_list_sections, "bootloader/ini", true, INI_CACHE_INI_DIR))
 	{
 		LIST_FOREACH_ENTRY(ini_sec_t, ini_sec, &ini_list_sections, link)
 		{
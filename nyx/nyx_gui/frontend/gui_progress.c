@@ -0,0 +1,100 @@
+/*
+ * Nyx progress reporting for long storage operations
+ *
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <bdk.h>
+
+#include "gui.h"
+#include "gui_progress.h"
+
+void gui_progress_init(gui_progress_t *prog, lv_obj_t *bar, lv_obj_t *label, u32 total)
+{
+	memset(prog, 0, sizeof(gui_progress_t));
+
+	prog->bar   = bar;
+	prog->label = label;
+	prog->total = total ? total : 1;
+
+	// First post always renders.
+	prog->render_timer = get_tmr_ms();
+}
+
+void gui_progress_render(gui_progress_t *prog)
+{
+	u32 now  = get_tmr_ms();
+	u32 done = MIN(prog->done, prog->total);
+	u32 pct  = ((u64)done * 100) / prog->total;
+
+	// Add sample to the rate window.
+	prog->win_ms[prog->win_pos]   = now;
+	prog->win_done[prog->win_pos] = done;
+	prog->win_pos = (prog->win_pos + 1) % GUI_PROG_WINDOW;
+	if (prog->win_cnt < GUI_PROG_WINDOW)
+		prog->win_cnt++;
+
+	lv_bar_set_value(prog->bar, pct);
+
+	if (prog->label)
+	{
+		// Get oldest sample.
+		u32 first = (prog->win_pos + GUI_PROG_WINDOW - prog->win_cnt) % GUI_PROG_WINDOW;
+		u32 dt_ms = now - prog->win_ms[first];
+		u32 dsct  = done - prog->win_done[first];
+
+		if (dt_ms && dsct && pct < 100)
+		{
+			// Rate in KiB/s and remaining time in seconds.
+			u32 rate_kb = ((u64)dsct * 1000 / 2) / dt_ms;
+			u32 eta_s   = ((u64)(prog->total - done) * dt_ms) / dsct / 1000;
+
+			s_printf(prog->txt, " "SYMBOL_DOT" %d%%  %d.%d MiB/s  %d:%02d", pct,
+				rate_kb / 1024, ((rate_kb % 1024) * 10) / 1024, eta_s / 60, eta_s % 60);
+		}
+		else
+			s_printf(prog->txt, " "SYMBOL_DOT" %d%%", pct);
+
+		lv_label_set_text(prog->label, prog->txt);
+	}
+
+	manual_system_maintenance(true);
+
+	prog->render_timer = get_tmr_ms() + GUI_PROG_RENDER_MS;
+}
+
+bool gui_progress_post(gui_progress_t *prog, u32 done)
+{
+	prog->done = done;
+
+	// Render at a fixed rate, regardless of how often progress is posted.
+	if (get_tmr_ms() < prog->render_timer)
+	{
+		manual_system_maintenance(false);
+		return false;
+	}
+
+	gui_progress_render(prog);
+
+	return true;
+}
+
+void gui_progress_done(gui_progress_t *prog)
+{
+	prog->done = prog->total;
+	gui_progress_render(prog);
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GUI_PROGRESS_H_
+#define _GUI_PROGRESS_H_
+
+#include <libs/lvgl/lvgl.h>
+#include <utils/types.h>
+
+#define GUI_PROG_RENDER_MS 66 // 15 fps.
+#define GUI_PROG_WINDOW    16 // Rate window, ~1s.
+
+typedef struct _gui_progress_t
+{
+	lv_obj_t *bar;
+	lv_obj_t *label;
+	u32 total;  // In sectors.
+	u32 done;   // Mailbox. Last posted sectors.
+	u32 render_timer;
+	u32 win_pos;
+	u32 win_cnt;
+	u32 win_ms[GUI_PROG_WINDOW];
+	u32 win_done[GUI_PROG_WINDOW];
+	char txt[48];
+} gui_progress_t;
+
+void gui_progress_init(gui_progress_t *prog, lv_obj_t *bar, lv_obj_t *label, u32 total);
+bool gui_progress_post(gui_progress_t *prog, u32 done);
+void gui_progress_render(gui_progress_t *prog);
+void gui_progress_done(gui_progress_t *prog);
+
+#endif
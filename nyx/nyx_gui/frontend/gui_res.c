@@ -0,0 +1,303 @@
+/*
+ * Nyx resources pager
+ *
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bdk.h>
+
+#include <libs/compr/lz4.h>
+#include <libs/compr/lz4c.h>
+#include <libs/fatfs/ff.h>
+
+#include "gui_res.h"
+
+#define GUI_RES_PATH    "bootloader/sys/res.pak"
+#define GUI_RES_PAGE_SZ SZ_32K // For uncompressed res.pak.
+
+#define GUI_RES_PAGING_MS      1
+#define GUI_RES_PAGING_IDLE_MS 500
+
+// res.pak table of contents. Same layout defines as the fonts and logos, sorted by offset.
+static const u32 _gui_res_toc[] = {
+	NYX_RES_UBUNTU_MONO_OFF,
+	NYX_RES_INTERUI_20_OFF,
+	NYX_RES_INTERUI_30_OFF,
+	NYX_RES_HEKATE_SYMBOL_20_OFF,
+	NYX_RES_HEKATE_SYMBOL_30_OFF,
+	NYX_RES_HEKATE_LOGO_OFF,
+	NYX_RES_CTCAER_LOGO_OFF,
+	NYX_RES_HEKATE_SYMBOL_120_OFF
+};
+
+static bool _gui_res_toc_valid(u32 size)
+{
+	// Must be sorted, so lookups find the right resource end.
+	for (u32 i = 1; i < ARRAY_SIZE(_gui_res_toc); i++)
+		if (_gui_res_toc[i] <= _gui_res_toc[i - 1])
+			return false;
+
+	// Last resource must exist in the pack. A smaller pack has a different layout.
+	return _gui_res_toc[ARRAY_SIZE(_gui_res_toc) - 1] < size;
+}
+
+typedef struct _gui_res_t
+{
+	bool lz4c;
+	u32  size;
+	u32  page_size;
+	u32  pages;
+	u32  pages_loaded;
+	u32 *page_offs;  // File offset of each page plus end of file.
+	u8  *page_loaded;
+	const lv_font_t *last_font;
+	lv_task_t *task;
+} gui_res_t;
+
+static gui_res_t res = { 0 };
+
+static bool _gui_res_page_load(FIL *fp, u32 idx, u8 *cbuf)
+{
+	u32 offset = idx * res.page_size;
+	u32 raw_size = MIN(res.page_size, res.size - offset);
+	u32 csize = res.page_offs[idx + 1] - res.page_offs[idx];
+	u8 *dst = (u8 *)NYX_RES_ADDR + offset;
+
+	if (f_lseek(fp, res.page_offs[idx]))
+		return false;
+
+	if (csize >= raw_size)
+	{
+		// Stored page. Read it directly.
+		if (csize != raw_size || f_read(fp, dst, raw_size, NULL))
+			return false;
+	}
+	else
+	{
+		if (f_read(fp, cbuf, csize, NULL))
+			return false;
+
+		if (LZ4_decompress_safe((const char *)cbuf, (char *)dst, csize, raw_size) != (int)raw_size)
+			return false;
+	}
+
+	res.page_loaded[idx] = 1;
+	res.pages_loaded++;
+	TRACE_MARK("res_page");
+
+	return true;
+}
+
+bool gui_res_load(u32 offset, u32 size)
+{
+	FIL fp;
+	bool success = true;
+
+	if (!res.pages || offset >= res.size)
+		return false;
+
+	if (size > res.size - offset)
+		size = res.size - offset;
+
+	u32 first = offset / res.page_size;
+	u32 last = (offset + size - 1) / res.page_size;
+
+	// Check if already loaded.
+	for (; first <= last; first++)
+		if (!res.page_loaded[first])
+			break;
+	if (first > last)
+		return true;
+
+	// Mount SD if needed. Card stays initialized after an unmount, so this is cheap.
+	bool mounted = sd_get_card_mounted();
+	if (!mounted && !sd_mount())
+		return false;
+
+	if (f_open(&fp, GUI_RES_PATH, FA_READ))
+	{
+		success = false;
+		goto out;
+	}
+
+	u8 *cbuf = res.lz4c ? malloc(res.page_size) : NULL;
+	for (u32 i = first; i <= last; i++)
+	{
+		if (!res.page_loaded[i] && !_gui_res_page_load(&fp, i, cbuf))
+		{
+			success = false;
+			break;
+		}
+	}
+	free(cbuf);
+
+	f_close(&fp);
+
+out:
+	if (!mounted)
+		sd_unmount();
+
+	return success;
+}
+
+bool gui_res_load_img(const lv_img_dsc_t *img)
+{
+	return gui_res_load((u32)img->data - NYX_RES_ADDR, img->data_size);
+}
+
+void gui_res_load_all()
+{
+	gui_res_load(0, res.size);
+}
+
+static void _gui_res_font_cb(const lv_font_t *font)
+{
+	// Fast path for the common case.
+	if (font == res.last_font || res.pages_loaded == res.pages)
+		return;
+
+	// Check if font is inside res.pak.
+	u32 offset = (u32)font->glyph_bitmap - NYX_RES_ADDR;
+	if (offset >= res.size)
+		return;
+
+	// Find the resource and load all of it.
+	u32 start = 0;
+	u32 end = res.size;
+	for (u32 i = 0; i < ARRAY_SIZE(_gui_res_toc); i++)
+	{
+		if (_gui_res_toc[i] <= offset)
+			start = _gui_res_toc[i];
+		else if (_gui_res_toc[i] < end)
+		{
+			end = _gui_res_toc[i];
+			break;
+		}
+	}
+
+	if (gui_res_load(start, end - start))
+		res.last_font = font;
+}
+
+static void _gui_res_paging_stop()
+{
+	lv_task_del(res.task);
+	res.task = NULL;
+}
+
+static void _gui_res_paging_task(void *param)
+{
+	// Only page in while SD is mounted by something else. Check again later otherwise.
+	if (!sd_get_card_mounted())
+	{
+		lv_task_set_period(res.task, GUI_RES_PAGING_IDLE_MS);
+		return;
+	}
+	lv_task_set_period(res.task, GUI_RES_PAGING_MS);
+
+	// Load one missing page per run, so GUI stays responsive.
+	for (u32 i = 0; i < res.pages; i++)
+	{
+		if (!res.page_loaded[i])
+		{
+			// Stop on error. Missing pages are still loaded on demand.
+			if (!gui_res_load(i * res.page_size, 1))
+				_gui_res_paging_stop();
+
+			return;
+		}
+	}
+
+	_gui_res_paging_stop();
+}
+
+void gui_res_start_paging()
+{
+	if (!res.task && res.pages_loaded != res.pages)
+		res.task = lv_task_create(_gui_res_paging_task, GUI_RES_PAGING_MS, LV_TASK_PRIO_LOWEST, NULL);
+}
+
+int gui_res_init()
+{
+	FIL fp;
+	lz4c_hdr_t hdr;
+	u32 *csizes = NULL;
+
+	// Reset pager in case of retry.
+	free(res.page_offs);
+	free(res.page_loaded);
+	memset(&res, 0, sizeof(gui_res_t));
+
+	if (f_open(&fp, GUI_RES_PATH, FA_READ))
+		return 1;
+
+	// Parse header and chunk table if compressed. Otherwise use fixed pages.
+	u32 fsize = f_size(&fp);
+	res.lz4c = fsize > sizeof(lz4c_hdr_t) &&
+			   !f_read(&fp, &hdr, sizeof(lz4c_hdr_t), NULL) &&
+			   hdr.magic == LZ4C_MAGIC;
+	if (res.lz4c)
+	{
+		if (!hdr.chunk_size || hdr.chunk_size > LZ4C_CHUNK_SIZE_MAX || hdr.size > NYX_RES_SZ ||
+			hdr.chunks != (hdr.size + hdr.chunk_size - 1) / hdr.chunk_size)
+			goto error;
+
+		res.size = hdr.size;
+		res.page_size = hdr.chunk_size;
+		res.pages = hdr.chunks;
+
+		csizes = malloc(res.pages * sizeof(u32));
+		if (f_read(&fp, csizes, res.pages * sizeof(u32), NULL))
+			goto error;
+	}
+	else
+	{
+		if (!fsize || fsize > NYX_RES_SZ)
+			goto error;
+
+		res.size = fsize;
+		res.page_size = GUI_RES_PAGE_SZ;
+		res.pages = (fsize + GUI_RES_PAGE_SZ - 1) / GUI_RES_PAGE_SZ;
+	}
+
+	// Build page index.
+	res.page_offs = malloc((res.pages + 1) * sizeof(u32));
+	res.page_loaded = calloc(res.pages, 1);
+	res.page_offs[0] = res.lz4c ? (sizeof(lz4c_hdr_t) + res.pages * sizeof(u32)) : 0;
+	for (u32 i = 0; i < res.pages; i++)
+	{
+		u32 csize = csizes ? csizes[i] : MIN(res.page_size, res.size - i * res.page_size);
+		res.page_offs[i + 1] = res.page_offs[i] + csize;
+	}
+
+	if (res.page_offs[res.pages] > fsize || !_gui_res_toc_valid(res.size))
+		goto error;
+
+	free(csizes);
+	f_close(&fp);
+
+	lv_font_set_bitmap_cb(_gui_res_font_cb);
+
+	return 0;
+
+error:
+	free(csizes);
+	free(res.page_offs);
+	free(res.page_loaded);
+	memset(&res, 0, sizeof(gui_res_t));
+	f_close(&fp);
+
+	return 1;
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GUI_RES_H_
+#define _GUI_RES_H_
+
+#include <libs/lvgl/lvgl.h>
+#include <utils/types.h>
+
+int  gui_res_init();
+bool gui_res_load(u32 offset, u32 size);
+bool gui_res_load_img(const lv_img_dsc_t *img);
+void gui_res_load_all();
+void gui_res_start_paging();
+
+#endif
@@ -23,6 +23,7 @@
 #include "gui_tools.h"
 #include "gui_tools_partition_manager.h"
 #include "gui_emmc_tools.h"
+#include "gui_res.h"
 #include "fe_emummc_tools.h"
 #include "../config.h"
 #include "../hos/pkg1.h"
@@ -125,6 +126,7 @@ bool get_set_autorcm_status(bool toggle)
 	}
 
 out:
+	emmc_cache_reset();
 	free(tempbuf);
 	emmc_end();
 
@@ -220,6 +222,9 @@ static lv_res_t _create_mbox_hid(usb_ctxt_t *usbs)
 
 static lv_res_t _create_mbox_ums(usb_ctxt_t *usbs)
 {
+	// SD can't be accessed while in UMS. Make sure that all resources are loaded.
+	gui_res_load_all();
+
 	lv_obj_t *dark_bg = lv_obj_create(lv_scr_act(), NULL);
 	lv_obj_set_style(dark_bg, &mbox_darken);
 	lv_obj_set_size(dark_bg, LV_HOR_RES, LV_VER_RES);
@@ -361,7 +366,7 @@ static lv_res_t _action_hid_jc(lv_obj_t *btn)
 {
 	// Reduce BPMP, RAM and backlight and power off SDMMC1 to conserve power.
 	sd_end();
-	minerva_change_freq(FREQ_800);
+	nyx_dvfs_set_high(false);
 	bpmp_freq_t prev_fid = bpmp_clk_rate_set(BPMP_CLK_NORMAL);
 	display_backlight_brightness(10, 1000);
 
@@ -373,7 +378,7 @@ static lv_res_t _action_hid_jc(lv_obj_t *btn)
 	_create_mbox_hid(&usbs);
 
 	// Restore BPMP, RAM and backlight.
-	minerva_change_freq(FREQ_1600);
+	nyx_dvfs_set_high(true);
 	bpmp_clk_rate_set(prev_fid);
 	display_backlight_brightness(h_cfg.backlight - 20, 1000);
 
@@ -385,7 +390,7 @@ static lv_res_t _action_hid_touch(lv_obj_t *btn)
 {
 	// Reduce BPMP, RAM and backlight and power off SDMMC1 to conserve power.
 	sd_end();
-	minerva_change_freq(FREQ_800);
+	nyx_dvfs_set_high(false);
 	bpmp_freq_t prev_fid = bpmp_clk_rate_set(BPMP_CLK_NORMAL);
 	display_backlight_brightness(10, 1000);
 
@@ -397,7 +402,7 @@ static lv_res_t _action_hid_touch(lv_obj_t *btn)
 	_create_mbox_hid(&usbs);
 
 	// Restore BPMP, RAM and backlight.
-	minerva_change_freq(FREQ_1600);
+	nyx_dvfs_set_high(true);
 	bpmp_clk_rate_set(prev_fid);
 	display_backlight_brightness(h_cfg.backlight - 20, 1000);
 
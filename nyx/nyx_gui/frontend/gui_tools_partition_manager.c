@@ -21,6 +21,7 @@
 #include "gui.h"
 #include "gui_tools.h"
 #include "gui_tools_partition_manager.h"
+#include "gui_res.h"
 #include <libs/fatfs/diskio.h>
 #include <libs/lvgl/lvgl.h>
 
@@ -299,7 +300,7 @@ static void _prepare_and_flash_mbr_gpt()
 	sdmmc_storage_read(&sd_storage, 0, 1, &mbr);
 
 	// Copy over metadata if they exist.
-	if (*(u32 *)&part_info.mbr_old.bootstrap[0x80])
+	if (*(u32 *)&part_info.mbr_old.bootstrap[0x80] || *(u32 *)&part_info.mbr_old.bootstrap[0xC0])
 		memcpy(&mbr.bootstrap[0x80], &part_info.mbr_old.bootstrap[0x80], 304);
 
 	// Clear the first 16MB.
@@ -1382,6 +1383,9 @@ static int _backup_and_restore_files(bool backup, lv_obj_t **labels)
 
 static lv_res_t _create_mbox_start_partitioning(lv_obj_t *btn)
 {
+	// SD gets repartitioned. Make sure that all resources are loaded.
+	gui_res_load_all();
+
 	lv_obj_t *dark_bg = lv_obj_create(lv_scr_act(), NULL);
 	lv_obj_set_style(dark_bg, &mbox_darken);
 	lv_obj_set_size(dark_bg, LV_HOR_RES, LV_VER_RES);
@@ -29,6 +29,8 @@
 
 #include "frontend/fe_emmc_tools.h"
 #include "frontend/gui.h"
+#include "frontend/gui_img_cache.h"
+#include "frontend/gui_res.h"
 
 nyx_config n_cfg;
 hekate_config h_cfg;
@@ -206,7 +208,7 @@ static void _load_saved_configuration()
 	LIST_INIT(ini_sections);
 	LIST_INIT(ini_nyx_sections);
 
-	if (!ini_parse(&ini_sections, "bootloader/hekate_ipl.ini", false))
+	if (!ini_parse_cached(&ini_sections, "bootloader/hekate_ipl.ini", false, INI_CACHE_IPL))
 	{
 		create_config_entry();
 		goto skip_main_cfg_parse;
@@ -282,6 +284,8 @@ skip_main_cfg_parse:
 					n_cfg.jc_force_right = atoi(kv->val) == 1;
 				else if (!strcmp("bpmpclock",    kv->key))
 					n_cfg.bpmp_clock     = atoi(kv->val);
+				else if (!strcmp("dramidle",     kv->key))
+					n_cfg.dram_idle      = atoi(kv->val);
 			}
 
 			break;
@@ -291,37 +295,10 @@ skip_main_cfg_parse:
 	ini_free(&ini_nyx_sections);
 }
 
-static int nyx_load_resources()
+static void nyx_load_bg()
 {
-	FIL fp;
-	int res;
-
-	res = f_open(&fp, "bootloader/sys/res.pak", FA_READ);
-	if (res)
-		return res;
-
-	res = f_read(&fp, (void *)NYX_RES_ADDR, f_size(&fp), NULL);
-	f_close(&fp);
-
-	return res;
-}
-
-static void nyx_load_bg_icons()
-{
-	// If no custom switch icon exists, load normal.
-	if (!f_stat("bootloader/res/icon_switch_custom.bmp", NULL))
-		icon_switch = bmp_to_lvimg_obj("bootloader/res/icon_switch_custom.bmp");
-	else
-		icon_switch = bmp_to_lvimg_obj("bootloader/res/icon_switch.bmp");
-
-	// If no custom payload icon exists, load normal.
-	if (!f_stat("bootloader/res/icon_payload_custom.bmp", NULL))
-		icon_payload = bmp_to_lvimg_obj("bootloader/res/icon_payload_custom.bmp");
-	else
-		icon_payload = bmp_to_lvimg_obj("bootloader/res/icon_payload.bmp");
-
-	// Load background resource if any.
-	hekate_bg = bmp_to_lvimg_obj("bootloader/res/background.bmp");
+	// Load background resource if any. Launch icons are loaded when first needed.
+	hekate_bg = gui_img_cache_load("bootloader/res/background.bmp");
 }
 
 #define EXCP_EN_ADDR   0x4003FFFC
@@ -436,6 +413,7 @@ void nyx_init_load_res()
 	_show_errors(SD_NO_ERROR);
 
 	// Try 2 times to mount SD card.
+	TRACE_BEGIN("sd_mount");
 	if (!sd_mount())
 	{
 		// Restore speed to SDR104.
@@ -445,20 +423,25 @@ void nyx_init_load_res()
 		if (!sd_mount())
 			_show_errors(SD_MOUNT_ERROR); // Fatal.
 	}
+	TRACE_END("sd_mount");
 
 	// Train DRAM and switch to max frequency.
+	TRACE_BEGIN("minerva_init");
 	minerva_init();
+	TRACE_END("minerva_init");
 
 	// Load hekate/Nyx configuration.
 	_load_saved_configuration();
 
-	// Load Nyx resources.
-	if (nyx_load_resources())
+	// Index Nyx resources. Fonts and images are paged in when first used.
+	TRACE_BEGIN("nyx_load_resources");
+	if (gui_res_init())
 	{
 		// Try again.
-		if (nyx_load_resources())
+		if (gui_res_init())
 			_show_errors(SD_FILE_ERROR); // Fatal since resources are mandatory.
 	}
+	TRACE_END("nyx_load_resources");
 
 	// Initialize nyx cfg to lower clock on first boot.
 	// In case of lower binned SoC, this can help with hangs.
@@ -488,8 +471,10 @@ void nyx_init_load_res()
 		break;
 	}
 
-	// Load default launch icons and background if it exists.
-	nyx_load_bg_icons();
+	// Load background if it exists.
+	TRACE_BEGIN("nyx_load_bg");
+	nyx_load_bg();
+	TRACE_END("nyx_load_bg");
 
 	// Unmount FAT partition.
 	sd_unmount();
@@ -500,6 +485,10 @@ void ipl_main()
 	// Set heap address.
 	heap_init((void *)IPL_HEAP_START);
 
+	// Continue boot profiling from hekate.
+	TRACE_INIT(TRACE_STAGE_NYX);
+	TRACE_MARK("nyx_main");
+
 	b_cfg = (boot_cfg_t *)(nyx_str->hekate + 0x94);
 
 #ifdef DEBUG_UART_PORT
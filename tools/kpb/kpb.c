@@ -0,0 +1,388 @@
+/*
+ * Kip patch bundle compiler.
+ * Converts hekate's patches.ini into a pre-parsed binary bundle (patches.bin).
+ *
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// Must match bootloader/hos/pkg2_ini_kippatch.h.
+#define KPB_MAGIC   0x3042504B // "KPB0".
+#define KPB_VERSION 2
+
+#define KPS(x) ((uint32_t)(x) << 29)
+
+#define MAX_KIPS      256
+#define MAX_PATCHSETS 16
+#define MAX_PATCHES   32
+
+typedef struct _kpb_hdr_t
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t size;
+	uint32_t ini_size;
+	uint32_t ini_crc32;
+	uint32_t kips_cnt;
+	uint32_t kips_off;
+	uint32_t psets_cnt;
+	uint32_t psets_off;
+	uint32_t patches_cnt;
+	uint32_t patches_off;
+	uint32_t ini_time; // Stamped by hekate.
+} kpb_hdr_t;
+
+typedef struct _patch_t
+{
+	uint32_t offset;
+	uint32_t length;
+	uint8_t *src;
+	uint8_t *dst;
+} patch_t;
+
+typedef struct _patchset_t
+{
+	char name[512];
+	uint32_t cnt;
+	patch_t patches[MAX_PATCHES];
+} patchset_t;
+
+typedef struct _kip_t
+{
+	char name[512];
+	uint8_t hash[8];
+	uint32_t cnt;
+	patchset_t *psets[MAX_PATCHSETS];
+} kip_t;
+
+static kip_t *kips[MAX_KIPS];
+static uint32_t kips_cnt;
+
+static uint8_t *blob;
+static uint32_t blob_size;
+static uint32_t blob_max;
+
+static void error(const char *msg, const char *arg)
+{
+	fprintf(stderr, "kpb: %s%s\n", msg, arg ? arg : "");
+	exit(1);
+}
+
+static uint32_t crc32_calc(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+	crc = ~crc;
+	for (uint32_t i = 0; i < len; i++)
+	{
+		crc ^= buf[i];
+		for (uint32_t j = 0; j < 8; j++)
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+	}
+
+	return ~crc;
+}
+
+// Same parsing rules as hekate's _htoa().
+static void htoa(uint8_t *dst, const char *ptr, uint32_t byte_len)
+{
+	while (*ptr == ' ' || *ptr == '\t')
+		ptr++;
+
+	for (uint32_t i = 0; i < byte_len * 2; i++)
+	{
+		char ch = *ptr;
+		uint8_t tmp = 0;
+		if (ch >= '0' && ch <= '9')
+			tmp = ch - '0';
+		else if (ch >= 'A' && ch <= 'F')
+			tmp = ch - 'A' + 10;
+		else if (ch >= 'a' && ch <= 'f')
+			tmp = ch - 'a' + 10;
+
+		if (!(i & 1))
+			dst[i / 2] = tmp << 4;
+		else
+			dst[i / 2] |= tmp;
+
+		if (ch)
+			ptr++;
+	}
+}
+
+static uint32_t find_section_name(char *lbuf, uint32_t lblen, char schar)
+{
+	uint32_t i;
+	for (i = 0; i < lblen && lbuf[i] != schar && lbuf[i] != '\n'; i++)
+		;
+	lbuf[i] = 0;
+
+	return i;
+}
+
+static kip_t *kip_get(char *name)
+{
+	kip_t kip = {0};
+
+	uint32_t i = find_section_name(name, strlen(name), ':') + 1;
+	strncpy(kip.name, name, sizeof(kip.name) - 1);
+	htoa(kip.hash, &name[i], 8);
+
+	// Sections with the same name and hash get merged.
+	for (i = 0; i < kips_cnt; i++)
+		if (!strcmp(kips[i]->name, kip.name) && !memcmp(kips[i]->hash, kip.hash, 8))
+			return kips[i];
+
+	if (kips_cnt == MAX_KIPS)
+		error("too many kips", NULL);
+
+	kips[kips_cnt] = malloc(sizeof(kip_t));
+	memcpy(kips[kips_cnt], &kip, sizeof(kip_t));
+
+	return kips[kips_cnt++];
+}
+
+static patch_t *patch_new(kip_t *kip, const char *name)
+{
+	patchset_t *pset = kip->cnt ? kip->psets[kip->cnt - 1] : NULL;
+
+	// Consecutive patches with the same name go in the same set.
+	if (!pset || strcmp(pset->name, name))
+	{
+		if (kip->cnt == MAX_PATCHSETS - 1)
+			error("too many patchsets for kip ", kip->name);
+
+		pset = calloc(1, sizeof(patchset_t));
+		strncpy(pset->name, name, sizeof(pset->name) - 1);
+		kip->psets[kip->cnt++] = pset;
+	}
+
+	if (pset->cnt == MAX_PATCHES - 1)
+		error("too many patches for ", pset->name);
+
+	return &pset->patches[pset->cnt++];
+}
+
+static void parse_ini(char *ini, uint32_t ini_size)
+{
+	kip_t *kip = NULL;
+	char *line = ini;
+
+	while (line < ini + ini_size)
+	{
+		char *end = memchr(line, '\n', ini + ini_size - line);
+		if (!end)
+			end = ini + ini_size;
+		*end = 0;
+
+		// Remove carriage returns, same as FatFs string functions.
+		char *lbuf = line;
+		uint32_t lblen = 0;
+		for (char *p = line; *p; p++)
+			if (*p != '\r')
+				lbuf[lblen++] = *p;
+		lbuf[lblen] = 0;
+
+		if (lblen > 2 && lbuf[0] == '[')
+		{
+			find_section_name(lbuf, lblen, ']');
+			kip = kip_get(&lbuf[1]);
+		}
+		else if (kip && lbuf[0] == '.')
+		{
+			uint32_t str_start;
+			uint32_t pos = find_section_name(lbuf, lblen, '=');
+			patch_t *pt = patch_new(kip, &lbuf[1]);
+
+			uint8_t kip_sidx = lbuf[pos + 1] - '0';
+			pos += 3;
+
+			if (kip_sidx < 6 && pos < lblen)
+			{
+				pt->offset = KPS(kip_sidx);
+				str_start = find_section_name(&lbuf[pos], lblen - pos, ':');
+				pt->offset |= strtol(&lbuf[pos], NULL, 16);
+				pos += str_start + 1;
+
+				str_start = pos < lblen ? find_section_name(&lbuf[pos], lblen - pos, ':') : 0;
+				pt->length = pos < lblen ? strtol(&lbuf[pos], NULL, 16) : 0;
+				pos += str_start + 1;
+
+				pt->src = calloc(pt->length + 1, 1);
+				pt->dst = calloc(pt->length + 1, 1);
+
+				if (pos < lblen)
+				{
+					str_start = find_section_name(&lbuf[pos], lblen - pos, ',');
+					htoa(pt->src, &lbuf[pos], pt->length);
+					pos += str_start + 1;
+				}
+
+				if (pos < lblen)
+					htoa(pt->dst, &lbuf[pos], pt->length);
+			}
+		}
+
+		line = end + 1;
+	}
+}
+
+static int kip_cmp(const void *a, const void *b)
+{
+	const kip_t *ka = *(const kip_t **)a;
+	const kip_t *kb = *(const kip_t **)b;
+
+	int res = strcmp(ka->name, kb->name);
+	if (!res)
+		res = memcmp(ka->hash, kb->hash, 8);
+
+	return res;
+}
+
+static uint32_t blob_add(const void *data, uint32_t size)
+{
+	if (blob_size + size + 4 > blob_max)
+	{
+		blob_max = (blob_size + size + 4) * 2;
+		blob = realloc(blob, blob_max);
+	}
+
+	uint32_t off = blob_size;
+	memcpy(blob + blob_size, data, size);
+	blob_size += size;
+
+	return off;
+}
+
+static void blob_align()
+{
+	uint32_t pad = 0;
+	blob_add(&pad, (4 - (blob_size & 3)) & 3);
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc != 3)
+	{
+		fprintf(stderr, "Uso: kpb <patches.ini> <patches.bin>\n");
+		return 1;
+	}
+
+	FILE *fp = fopen(argv[1], "rb");
+	if (!fp)
+		error("cannot open ", argv[1]);
+
+	fseek(fp, 0, SEEK_END);
+	uint32_t ini_size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	char *ini = malloc(ini_size + 1);
+	if (fread(ini, 1, ini_size, fp) != ini_size)
+		error("cannot read ", argv[1]);
+	fclose(fp);
+	ini[ini_size] = 0;
+
+	kpb_hdr_t hdr = {0};
+	hdr.magic = KPB_MAGIC;
+	hdr.version = KPB_VERSION;
+	hdr.ini_size = ini_size;
+	hdr.ini_crc32 = crc32_calc(0, (uint8_t *)ini, ini_size);
+
+	parse_ini(ini, ini_size);
+
+	// Sort by kip name and hash.
+	qsort(kips, kips_cnt, sizeof(kip_t *), kip_cmp);
+
+	// Count table entries. Every patchset and patch list is null terminated.
+	for (uint32_t i = 0; i < kips_cnt; i++)
+	{
+		hdr.psets_cnt += kips[i]->cnt + 1;
+		for (uint32_t j = 0; j < kips[i]->cnt; j++)
+			hdr.patches_cnt += kips[i]->psets[j]->cnt + 1;
+	}
+
+	hdr.kips_cnt    = kips_cnt;
+	hdr.kips_off    = sizeof(kpb_hdr_t);
+	hdr.psets_off   = hdr.kips_off  + kips_cnt * 16;
+	hdr.patches_off = hdr.psets_off + hdr.psets_cnt * 8;
+	uint32_t data_off = hdr.patches_off + hdr.patches_cnt * 16;
+
+	uint32_t *kips_tbl    = calloc(kips_cnt + 1, 16);
+	uint32_t *psets_tbl   = calloc(hdr.psets_cnt + 1, 8);
+	uint32_t *patches_tbl = calloc(hdr.patches_cnt + 1, 16);
+
+	// Build tables. Pointers are stored as offsets from bundle start.
+	uint32_t pset_idx = 0;
+	uint32_t patch_idx = 0;
+	for (uint32_t i = 0; i < kips_cnt; i++)
+	{
+		kip_t *kip = kips[i];
+		uint32_t *kip_ent = &kips_tbl[i * 4];
+
+		kip_ent[0] = data_off + blob_add(kip->name, strlen(kip->name) + 1);
+		memcpy(&kip_ent[1], kip->hash, 8);
+		kip_ent[3] = hdr.psets_off + pset_idx * 8;
+
+		for (uint32_t j = 0; j < kip->cnt; j++)
+		{
+			patchset_t *pset = kip->psets[j];
+			uint32_t *pset_ent = &psets_tbl[pset_idx * 2];
+
+			pset_ent[0] = data_off + blob_add(pset->name, strlen(pset->name) + 1);
+			pset_ent[1] = hdr.patches_off + patch_idx * 16;
+			blob_align();
+
+			for (uint32_t k = 0; k < pset->cnt; k++)
+			{
+				patch_t *pt = &pset->patches[k];
+				uint32_t *patch_ent = &patches_tbl[patch_idx * 4];
+
+				patch_ent[0] = pt->offset;
+				patch_ent[1] = pt->length;
+				if (pt->length)
+				{
+					patch_ent[2] = data_off + blob_add(pt->src, pt->length);
+					patch_ent[3] = data_off + blob_add(pt->dst, pt->length);
+				}
+				else
+					patch_ent[2] = pset_ent[0]; // Empty patch. Must be reported as such.
+				patch_idx++;
+			}
+			patch_idx++; // Terminator.
+			blob_align();
+		}
+		pset_idx++; // Terminator.
+	}
+
+	hdr.size = data_off + blob_size;
+
+	fp = fopen(argv[2], "wb");
+	if (!fp)
+		error("cannot create ", argv[2]);
+
+	fwrite(&hdr, sizeof(hdr), 1, fp);
+	fwrite(kips_tbl, 16, kips_cnt, fp);
+	fwrite(psets_tbl, 8, hdr.psets_cnt, fp);
+	fwrite(patches_tbl, 16, hdr.patches_cnt, fp);
+	if (blob_size)
+		fwrite(blob, 1, blob_size, fp);
+	fclose(fp);
+
+	printf("kpb: %d kips, %d patchsets, %d bytes\n", kips_cnt, hdr.psets_cnt - kips_cnt, hdr.size);
+
+	return 0;
+}
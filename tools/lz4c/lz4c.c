@@ -0,0 +1,152 @@
+/*
+ * LZ4 chunked packer.
+ * Compresses nyx.bin and res.pak so hekate and Nyx can decompress them per chunk while reading.
+ *
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "lz4.h"
+
+// Must match bdk/libs/compr/lz4c.h.
+#define LZ4C_MAGIC          0x43345A4C // "LZ4C".
+#define LZ4C_CHUNK_SIZE_MAX (4 * 1024 * 1024)
+
+#define LZ4C_CHUNK_SIZE_DEF (128 * 1024)
+
+typedef struct _lz4c_hdr_t
+{
+	uint32_t magic;
+	uint32_t size;
+	uint32_t chunk_size;
+	uint32_t chunks;
+} lz4c_hdr_t;
+
+static uint8_t *_read_file(const char *path, uint32_t *size)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f)
+		return NULL;
+
+	fseek(f, 0, SEEK_END);
+	long fsize = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	uint8_t *buf = malloc(fsize ? fsize : 1);
+	if (fread(buf, 1, fsize, f) != (size_t)fsize)
+	{
+		free(buf);
+		fclose(f);
+		return NULL;
+	}
+	fclose(f);
+
+	*size = fsize;
+
+	return buf;
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t chunk_size = LZ4C_CHUNK_SIZE_DEF;
+
+	if (argc == 5 && !strcmp(argv[1], "-c"))
+	{
+		chunk_size = strtoul(argv[2], NULL, 0) * 1024;
+		argv += 2;
+		argc -= 2;
+	}
+
+	if (argc != 3 || !chunk_size || chunk_size > LZ4C_CHUNK_SIZE_MAX)
+	{
+		printf("Usage: lz4c [-c <chunk size in KiB>] <input> <output>\n");
+		return 1;
+	}
+
+	uint32_t size;
+	uint8_t *in = _read_file(argv[1], &size);
+	if (!in)
+	{
+		printf("Failed to read %s\n", argv[1]);
+		return 1;
+	}
+
+	if (size >= 4 && *(uint32_t *)in == LZ4C_MAGIC)
+	{
+		printf("%s is already compressed\n", argv[1]);
+		return 1;
+	}
+
+	lz4c_hdr_t hdr;
+	hdr.magic      = LZ4C_MAGIC;
+	hdr.size       = size;
+	hdr.chunk_size = chunk_size;
+	hdr.chunks     = (size + chunk_size - 1) / chunk_size;
+
+	uint32_t *csizes = calloc(hdr.chunks ? hdr.chunks : 1, sizeof(uint32_t));
+	uint8_t *out = malloc(LZ4_compressBound(size) + hdr.chunks * sizeof(uint32_t) + 1);
+	uint8_t *verify = malloc(chunk_size);
+	uint32_t out_size = 0;
+
+	for (uint32_t i = 0; i < hdr.chunks; i++)
+	{
+		uint32_t offset = i * chunk_size;
+		uint32_t raw_size = (size - offset) < chunk_size ? (size - offset) : chunk_size;
+
+		int csize = LZ4_compress_default((const char *)in + offset, (char *)out + out_size, raw_size, LZ4_compressBound(raw_size));
+
+		// Store chunk as is if it does not compress.
+		if (csize <= 0 || (uint32_t)csize >= raw_size)
+		{
+			memcpy(out + out_size, in + offset, raw_size);
+			csize = raw_size;
+		}
+		else if (LZ4_decompress_safe((const char *)out + out_size, (char *)verify, csize, chunk_size) != (int)raw_size ||
+				 memcmp(verify, in + offset, raw_size))
+		{
+			printf("Chunk %d failed verification\n", i);
+			return 1;
+		}
+
+		csizes[i] = csize;
+		out_size += csize;
+	}
+
+	FILE *f = fopen(argv[2], "wb");
+	if (!f)
+	{
+		printf("Failed to create %s\n", argv[2]);
+		return 1;
+	}
+
+	fwrite(&hdr, sizeof(lz4c_hdr_t), 1, f);
+	fwrite(csizes, sizeof(uint32_t), hdr.chunks, f);
+	fwrite(out, 1, out_size, f);
+	fclose(f);
+
+	uint32_t total = sizeof(lz4c_hdr_t) + hdr.chunks * sizeof(uint32_t) + out_size;
+	printf("%s: %d -> %d bytes (%d%%), %d chunks\n", argv[2], size, total, size ? (int)((uint64_t)total * 100 / size) : 0, hdr.chunks);
+
+	free(verify);
+	free(out);
+	free(csizes);
+	free(in);
+
+	return 0;
+}
@@ -0,0 +1,5 @@
+// Host shim for bdk's lz4.c. Provides what bdk's heap.h and types.h do.
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef uint8_t BYTE;
@@ -0,0 +1,4 @@
+// Host shim for bdk's module.h. Only the heap type is needed.
+#include <stdlib.h>
+
+typedef struct _heap heap_t;
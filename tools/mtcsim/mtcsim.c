@@ -0,0 +1,324 @@
+/*
+ * Minerva Training Cell host simulator.
+ * Runs the Minerva module against a simulated MC/EMC/CAR register file and
+ * reports the register sequence and delays of each frequency switch.
+ *
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mtc.h"
+#include "mtc_mc_emc_regs.h"
+#include "mtcsim.h"
+
+#define SIM_BANK_SIZE 0x1000
+
+typedef struct _sim_reg_name_t
+{
+	u32 off;
+	const char *name;
+} sim_reg_name_t;
+
+static const sim_reg_name_t mc_regs[] = {
+#include "mc_regs.inc"
+};
+
+static const sim_reg_name_t emc_regs[] = {
+#include "emc_regs.inc"
+};
+
+typedef struct _sim_bank_t
+{
+	u32 base;
+	const char *name;
+	const sim_reg_name_t *names;
+	u32 names_cnt;
+	u32 regs[SIM_BANK_SIZE / sizeof(u32)];
+} sim_bank_t;
+
+static sim_bank_t banks[] = {
+	{ TMR_BASE,   "TMR",     NULL,     0,                                          { 0 } },
+	{ CLOCK_BASE, "CAR",     NULL,     0,                                          { 0 } },
+	{ MC_BASE,    "MC",      mc_regs,  sizeof(mc_regs)  / sizeof(sim_reg_name_t), { 0 } },
+	{ EMC_BASE,   "EMC",     emc_regs, sizeof(emc_regs) / sizeof(sim_reg_name_t), { 0 } },
+	{ EMC0_BASE,  "EMC_CH0", emc_regs, sizeof(emc_regs) / sizeof(sim_reg_name_t), { 0 } },
+	{ EMC1_BASE,  "EMC_CH1", emc_regs, sizeof(emc_regs) / sizeof(sim_reg_name_t), { 0 } }
+};
+
+#define SIM_BANKS (sizeof(banks) / sizeof(sim_bank_t))
+
+typedef struct _sim_stats_t
+{
+	u32 writes;
+	u32 reads;
+	u32 bank_writes[SIM_BANKS];
+	u32 ccfifo_entries;
+	u32 ccfifo_clocks; // Programmed CCFIFO delays in EMC clocks.
+	u32 wait_us;       // Timed waits and polls, in simulated us.
+	u32 waits;
+} sim_stats_t;
+
+static sim_stats_t stats;
+static bool verbose;
+
+static u32 sim_us;
+static u32 sim_wait_start;
+static bool sim_waiting;
+static bool mrr_pending;
+
+static sim_bank_t *_sim_get_bank(u32 base, u32 *off)
+{
+	// EMC aliases the per channel EMC0/EMC1 registers above 0x3000.
+	u32 addr = base + *off;
+
+	for (u32 i = 0; i < SIM_BANKS; i++)
+	{
+		if (addr >= banks[i].base && addr < (banks[i].base + SIM_BANK_SIZE))
+		{
+			*off = addr - banks[i].base;
+			if (*off & 3)
+				break;
+
+			return &banks[i];
+		}
+	}
+
+	fprintf(stderr, "Bad access: 0x%08X + 0x%X\n", base, *off);
+	exit(1);
+}
+
+static const char *_sim_reg_name(sim_bank_t *bank, u32 off)
+{
+	static char name[32];
+
+	for (u32 i = 0; i < bank->names_cnt; i++)
+		if (bank->names[i].off == off)
+			return bank->names[i].name;
+
+	snprintf(name, sizeof(name), "%s_0x%03X", bank->name, off);
+
+	return name;
+}
+
+static void _sim_wait_end()
+{
+	if (!sim_waiting)
+		return;
+
+	u32 waited = sim_us - sim_wait_start;
+	stats.wait_us += waited;
+	stats.waits++;
+	sim_waiting = false;
+
+	if (verbose)
+		printf("  wait %u us\n", waited);
+}
+
+u32 sim_rd(u32 base, u32 off)
+{
+	sim_bank_t *bank = _sim_get_bank(base, &off);
+	u32 val = bank->regs[off / sizeof(u32)];
+	base = bank->base;
+
+	// Timer. Every poll costs 1 us of simulated time.
+	if (base == TMR_BASE)
+	{
+		if (!sim_waiting)
+		{
+			sim_waiting = true;
+			sim_wait_start = sim_us;
+		}
+
+		return sim_us++;
+	}
+
+	_sim_wait_end();
+	stats.reads++;
+
+	// Status bits that hardware sets on its own.
+	switch (base)
+	{
+	case CLOCK_BASE:
+		if (off == CLK_RST_CONTROLLER_PLLM_BASE || off == CLK_RST_CONTROLLER_PLLMB_BASE)
+			val |= PLLM_LOCK;
+		break;
+	case EMC_BASE:
+	case EMC0_BASE:
+	case EMC1_BASE:
+		if (off == EMC_INTSTATUS)
+			val |= CLKCHANGE_COMPLETE_INT;
+		else if (off == EMC_EMC_STATUS)
+			val = mrr_pending ? MRR_DIVLD : 0; // Never stalled, powered down or in self refresh.
+		else if (off == EMC_DIG_DLL_STATUS)
+			val |= BIT(17) | BIT(15);
+		else if (off == EMC_MRR)
+		{
+			// Return nominal MR4 refresh rate and a fixed DQS oscillator count for MR18/MR19.
+			mrr_pending = false;
+			if (((val >> 16) & 0xFF) == 4)
+				val = (val & 0xFFFF0000) | 3;
+			else
+				val = (val & 0xFFFF0000) | 0x0101;
+		}
+		break;
+	}
+
+	return val;
+}
+
+static void _sim_store(sim_bank_t *bank, u32 off, u32 val)
+{
+	bank->regs[off / sizeof(u32)] = val;
+
+	// EMC writes are broadcast to both channels.
+	if (bank->base == EMC_BASE)
+	{
+		banks[4].regs[off / sizeof(u32)] = val;
+		banks[5].regs[off / sizeof(u32)] = val;
+	}
+}
+
+void sim_poke(u32 base, u32 off, u32 val)
+{
+	sim_bank_t *bank = _sim_get_bank(base, &off);
+
+	_sim_store(bank, off, val);
+}
+
+void sim_wr(u32 base, u32 off, u32 val)
+{
+	sim_bank_t *bank = _sim_get_bank(base, &off);
+	base = bank->base;
+
+	_sim_wait_end();
+
+	_sim_store(bank, off, val);
+
+	stats.writes++;
+	stats.bank_writes[bank - banks]++;
+
+	if (base == EMC_BASE)
+	{
+		if (off == EMC_MRR)
+			mrr_pending = true;
+		else if (off == EMC_CCFIFO_ADDR)
+		{
+			stats.ccfifo_entries++;
+			stats.ccfifo_clocks += (val >> 16) & 0x7FFF;
+		}
+	}
+
+	if (verbose)
+		printf("  %-8s %-48s = 0x%08X\n", bank->name, _sim_reg_name(bank, off), val);
+}
+
+void _minerva_init(mtc_config_t *mtc_cfg, void *bp);
+void sim_seed(emc_table_t *entry);
+
+static void _sim_run(mtc_config_t *mtc_cfg, const char *step)
+{
+	u32 start_us = sim_us;
+
+	memset(&stats, 0, sizeof(stats));
+
+	if (verbose)
+		printf("%s\n", step);
+
+	_minerva_init(mtc_cfg, NULL);
+	_sim_wait_end();
+
+	printf("%-28s %6u writes %6u reads %5u waits %8u us waited %4u ccfifo %7u clk delays (",
+		   step, stats.writes, stats.reads, stats.waits, sim_us - start_us, stats.ccfifo_entries, stats.ccfifo_clocks);
+	for (u32 i = 0; i < SIM_BANKS; i++)
+		printf("%s%s %u", i ? ", " : "", banks[i].name, stats.bank_writes[i]);
+	printf(")\n");
+}
+
+static void _sim_switch(mtc_config_t *mtc_cfg, u32 mode, u32 rate_to)
+{
+	char step[64];
+	static const char *modes[] = { "switch", "train", "train+switch", "periodic", "temp comp" };
+
+	mtc_cfg->rate_to = rate_to;
+	mtc_cfg->train_mode = mode;
+
+	if (mode == OP_PERIODIC_TRAIN || mode == OP_TEMP_COMP)
+		snprintf(step, sizeof(step), "%s @ %u", modes[mode], mtc_cfg->rate_from / 1000);
+	else
+		snprintf(step, sizeof(step), "%s %u -> %u", modes[mode], mtc_cfg->rate_from / 1000, rate_to / 1000);
+
+	_sim_run(mtc_cfg, step);
+}
+
+int main(int argc, char **argv)
+{
+	u32 sdram_id = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-v"))
+			verbose = true;
+		else if (!strcmp(argv[i], "-d") && (i + 1) < argc)
+			sdram_id = strtoul(argv[++i], NULL, 0);
+		else
+		{
+			printf("Usage: %s [-v] [-d sdram_id]\n", argv[0]);
+			printf("  -v  Log every register write and timed wait.\n");
+			printf("  -d  DRAM id as returned by fuse_read_dramid().\n");
+			return 1;
+		}
+	}
+
+	mtc_config_t *mtc_cfg = calloc(1, sizeof(mtc_config_t));
+	mtc_cfg->mtc_table = calloc(10, EMC_TABLE_ENTRY_SIZE_R7);
+	mtc_cfg->sdram_id = sdram_id;
+	mtc_cfg->init_done = MTC_NEW_MAGIC;
+	_minerva_init(mtc_cfg, NULL);
+
+	if (mtc_cfg->init_done != MTC_INIT_MAGIC)
+	{
+		printf("Minerva failed to initialize!\n");
+		return 1;
+	}
+
+	// Boot state is the first table entry (204 MHz).
+	emc_table_t *boot = &mtc_cfg->mtc_table[0];
+	sim_seed(boot);
+	sim_poke(CLOCK_BASE, CLK_RST_CONTROLLER_CLK_SOURCE_EMC, boot->clk_src_emc);
+	mtc_cfg->rate_from = boot->rate_khz;
+
+	printf("DRAM id %u, %u table entries, %u KHz boot rate.\n\n", sdram_id, mtc_cfg->table_entries, boot->rate_khz);
+
+	// Replay hekate's minerva_init() and Nyx's frequency scaling.
+	_sim_switch(mtc_cfg, OP_TRAIN, 204000);
+	_sim_switch(mtc_cfg, OP_TRAIN, 800000);
+	_sim_switch(mtc_cfg, OP_TRAIN, 1600000);
+	_sim_switch(mtc_cfg, OP_SWITCH, 800000);
+	_sim_switch(mtc_cfg, OP_SWITCH, 1600000);
+	_sim_switch(mtc_cfg, OP_PERIODIC_TRAIN, 0);
+	_sim_switch(mtc_cfg, OP_TEMP_COMP, 0);
+	_sim_switch(mtc_cfg, OP_SWITCH, 800000);
+	_sim_switch(mtc_cfg, OP_SWITCH, 1600000);
+
+	printf("\nTotal simulated time: %u us\n", sim_us);
+
+	free(mtc_cfg->mtc_table);
+	free(mtc_cfg);
+
+	return 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * Minerva Training Cell host simulator
+ *
+ * Copyright (c) 2026 CTCaer
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MTCSIM_H_
+#define _MTCSIM_H_
+
+/* Redirect all register reads to the simulated register file. Writes are rewritten by sim_src.py. */
+#undef TMR
+#undef CLOCK
+#undef MC
+#undef EMC
+#undef EMC_CH0
+#undef EMC_CH1
+
+#define TMR(off)     sim_rd(TMR_BASE,   (off))
+#define CLOCK(off)   sim_rd(CLOCK_BASE, (off))
+#define MC(off)      sim_rd(MC_BASE,    (off))
+#define EMC(off)     sim_rd(EMC_BASE,   (off))
+#define EMC_CH0(off) sim_rd(EMC0_BASE,  (off))
+#define EMC_CH1(off) sim_rd(EMC1_BASE,  (off))
+
+unsigned int sim_rd(unsigned int base, unsigned int off);
+void sim_wr(unsigned int base, unsigned int off, unsigned int val);
+void sim_poke(unsigned int base, unsigned int off, unsigned int val);
+
+static inline unsigned int sim_div(unsigned int a, unsigned int b)
+{
+	return b ? (a / b) : 0;
+}
+
+#endif
@@ -0,0 +1,57 @@
+import re
+import sys
+
+# Rewrites Minerva register writes to simulator calls.
+# Reads are redirected by the macros in mtcsim.h.
+
+f = open(sys.argv[1], "r")
+buf = f.read()
+f.close()
+
+bases = {
+	"TMR":     "TMR_BASE",
+	"CLOCK":   "CLOCK_BASE",
+	"MC":      "MC_BASE",
+	"EMC":     "EMC_BASE",
+	"EMC_CH0": "EMC0_BASE",
+	"EMC_CH1": "EMC1_BASE"
+}
+
+def fix(m):
+	what = m.groups()[0]
+	off = m.groups()[1]
+	op = m.groups()[2]
+	val = m.groups()[3]
+	if op:
+		val = "{0}({1}) {2} ({3})".format(what, off, op, val)
+	return "sim_wr({0}, {1}, {2});".format(bases[what], off, val)
+
+buf, cnt = re.subn(r'\b(EMC_CH0|EMC_CH1|EMC|MC|CLOCK|TMR)\(([^()]+)\)\s*([|&^]?)=(?!=)\s*([^;]+);', fix, buf)
+# Clock tree updates can divide by a zero oscillator count. ARM's division helper returns 0 there.
+buf = re.sub(r'tval / \(([^()]+)\)', r'sim_div(tval, \1)', buf)
+
+buf = buf.replace("#include <module.h>\n", "#include <module.h>\n#include \"mtcsim.h\"\n", 1)
+
+# BDK params are only used for the overclock voltage.
+buf = buf.replace("void _minerva_init(mtc_config_t *mtc_cfg, bdkParams_t bp)\n{\n",
+	"void _minerva_init(mtc_config_t *mtc_cfg, bdkParams_t bp)\n{\n\t(void)bp;\n", 1)
+
+# Boot state helper. Programs the burst registers of an entry, like the bootrom/bootloader do.
+buf += """
+void sim_seed(emc_table_t *entry)
+{
+	burst_regs_table_t *burst_regs = (burst_regs_table_t *)&entry->burst_regs;
+
+	for (u32 i = 0; i < entry->num_burst; i++)
+		sim_poke(EMC_BASE, burst_regs_emc_addr_table[i], burst_regs->burst_regs[i]);
+
+	for (u32 i = 0; i < entry->num_mc_regs; i++)
+		sim_poke(MC_BASE, burst_mc_regs_addr_table[i], entry->burst_mc_regs[i]);
+}
+"""
+
+f = open(sys.argv[2], "w")
+f.write(buf)
+f.close()
+
+print("Rewrote {0} register writes.".format(cnt))